@@ -0,0 +1,464 @@
+/// Benchmarks for dsu, components, Fenwick, SegmentTree, dijkstra and solver / chunkedSolver (see include/ads).
+
+/// Every benchmark runs a seeded synthetic workload at several scales, and reports as JSON:
+/// the time per operation (ns/op), the throughput (ops/s), the peak resident memory during the benchmark (KB),
+/// and the hardware counters read through perf_event (null if they aren't available, e.g. in containers).
+/// dsu and solver also run with the statistics enabled (the "_stats" entries), so the cost of the default noStats policy can be tracked.
+
+/// How to use:
+
+/// g++ -O2 -std=c++17 -pthread benchmark.cpp -o benchmark (or build the benchmark target, see CMakeLists.txt)
+/// ./benchmark > results.json
+
+#include <bits/stdc++.h>
+
+#include <malloc.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+#include "include/ads/dsu.h"
+#include "include/ads/components.h"
+#include "include/ads/fenwick.h"
+#include "include/ads/segment-tree.h"
+#include "include/ads/graph.h"
+#include "include/ads/dijkstra.h"
+#include "include/ads/dynamic-connectivity.h"
+
+class counters {
+    /// Hardware counters of the current thread, read through perf_event_open.
+
+    private:
+        static const int K = 4;
+        int fd[K];
+    public:
+        const char *name[K] = {"cycles", "instructions", "cache_misses", "branch_misses"};
+        long long value[K];
+
+        counters () {
+            unsigned long long config[K] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+
+            for (int i = 0; i < K; ++ i) {
+                perf_event_attr attr;
+
+                memset(&attr, 0, sizeof(attr));
+                attr.size = sizeof(attr);
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = config[i];
+                attr.disabled = 1;
+                attr.exclude_kernel = 1;
+                attr.exclude_hv = 1;
+
+                fd[i] = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+            }
+        }
+
+        ~counters () {
+            for (int i = 0; i < K; ++ i)
+                if (fd[i] != -1)
+                    close(fd[i]);
+        }
+
+        void start() {
+            for (int i = 0; i < K; ++ i)
+                if (fd[i] != -1) {
+                    ioctl(fd[i], PERF_EVENT_IOC_RESET, 0);
+                    ioctl(fd[i], PERF_EVENT_IOC_ENABLE, 0);
+                }
+
+            return;
+        }
+
+        void stop() {
+            for (int i = 0; i < K; ++ i) {
+                value[i] = -1;
+
+                if (fd[i] != -1) {
+                    ioctl(fd[i], PERF_EVENT_IOC_DISABLE, 0);
+
+                    if (read(fd[i], &value[i], sizeof(value[i])) != sizeof(value[i]))
+                        value[i] = -1;
+                }
+            }
+
+            return;
+        }
+
+        int size() {
+            return K;
+        }
+};
+
+long long peakMemory() {
+    /// The peak resident memory (KB) since the last resetPeakMemory(), or since the process started.
+
+    std :: ifstream status("/proc/self/status");
+    std :: string line;
+
+    while (std :: getline(status, line))
+        if (line.compare(0, 6, "VmHWM:") == 0)
+            return std :: stoll(line.substr(6));
+
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+
+    return usage.ru_maxrss;
+}
+
+void resetPeakMemory() {
+    malloc_trim(0); /// Gives the memory freed by the previous benchmarks back to the system.
+
+    std :: ofstream clear("/proc/self/clear_refs");
+
+    clear << "5"; /// Resets the peak to the current resident memory (Linux >= 4.0).
+
+    return;
+}
+
+counters hw;
+bool first = true;
+
+template < typename F >
+    void measure(std :: string name, long long scale, long long ops, F run) {
+        /// Runs run() once and prints its results as a JSON object. ops = the number of operations done by run().
+
+        resetPeakMemory();
+        hw.start();
+
+        std :: chrono :: steady_clock :: time_point begin = std :: chrono :: steady_clock :: now();
+
+        run();
+
+        double ns = std :: chrono :: duration < double, std :: nano > (std :: chrono :: steady_clock :: now() - begin).count();
+
+        hw.stop();
+
+        std :: cout << (first ? "" : ",\n") << "  {\"benchmark\": \"" << name << "\", \"scale\": " << scale << ", \"ops\": " << ops
+                    << std :: fixed << std :: setprecision(2) << ", \"ns_per_op\": " << ns / ops << ", \"ops_per_sec\": " << ops / ns * 1e9
+                    << ", \"peak_rss_kb\": " << peakMemory();
+
+        for (int i = 0; i < hw.size(); ++ i) {
+            std :: cout << ", \"" << hw.name[i] << "\": ";
+
+            if (hw.value[i] == -1)
+                std :: cout << "null";
+            else
+                std :: cout << hw.value[i];
+        }
+
+        std :: cout << "}";
+        std :: cout.flush();
+
+        first = false;
+
+        return;
+    }
+
+long long sink; /// Keeps the compiler from removing the results.
+
+template < typename Stats >
+    void benchDsu(std :: string name, int n) {
+        /// n vertices, 2n operations: half of them add an edge, half of them query two vertices.
+        /// Run with noStats ("dsu") and stats ("dsu_stats"): "dsu" tracks the cost of the disabled policy (see stats.h).
+
+        std :: mt19937 gen(n);
+        std :: vector < std :: array < int, 3 > > q(2 * n);
+
+        for (int i = 0; i < 2 * n; ++ i)
+            q[i] = {int(gen() % 2), int(gen() % n), int(gen() % n)};
+
+        measure(name, n, 2 * n, [&]() {
+            ads :: dsu < Stats > T(n);
+
+            for (int i = 0; i < 2 * n; ++ i) {
+                if (q[i][0] == 0)
+                    T.add(q[i][1], q[i][2]);
+                else
+                    sink += T.query(q[i][1], q[i][2]);
+            }
+        });
+
+        return;
+    }
+
+void benchComponents(int m) {
+    /// A random graph with m / 4 vertices and m edges, labeled with dsu :: add (one edge at a time), then with components
+    /// (on the same graph in CSR format, built separately) followed by dsu :: load. An operation = an edge.
+
+    int n = m / 4;
+
+    std :: mt19937 gen(m);
+    std :: vector < std :: pair < int, int > > edges(m);
+
+    for (int i = 0; i < m; ++ i)
+        edges[i] = {int(gen() % n), int(gen() % n)};
+
+    measure("dsu_components", m, m, [&]() {
+        ads :: dsu T(n);
+
+        for (int i = 0; i < m; ++ i)
+            T.add(edges[i].first, edges[i].second);
+
+        sink += T.query(0, n - 1);
+    });
+
+    std :: vector < long long > offsets;
+    std :: vector < int > adj;
+
+    ads :: toCSR(n, edges, offsets, adj);
+
+    edges = std :: vector < std :: pair < int, int > > ();
+
+    measure("afforest_components", m, m, [&]() {
+        ads :: dsu T(n);
+
+        T.load(ads :: components(n, offsets, adj));
+
+        sink += T.query(0, n - 1);
+    });
+
+    return;
+}
+
+void benchFenwick(int n) {
+    /// An array of n elements (built separately), then n operations: half range additions, half range sums.
+
+    std :: mt19937 gen(n);
+    std :: vector < long long > a(n);
+    std :: vector < std :: array < int, 4 > > q(n);
+
+    for (int i = 0; i < n; ++ i)
+        a[i] = gen() % 1000;
+
+    for (int i = 0; i < n; ++ i)
+        q[i] = {int(gen() % 2), int(gen() % n + 1), int(gen() % n + 1), int(gen() % 1000)};
+
+    ads :: Fenwick < long long > *T = nullptr;
+
+    measure("fenwick_build", n, n, [&]() {
+        T = new ads :: Fenwick < long long > (a);
+    });
+
+    measure("fenwick", n, n, [&]() {
+        for (int i = 0; i < n; ++ i) {
+            if (q[i][0] == 0)
+                T -> Update(q[i][1], q[i][2], q[i][3]);
+            else
+                sink += T -> Query(q[i][1], q[i][2]);
+        }
+    });
+
+    delete T;
+
+    const char *path = "benchmark-fenwick.bin";
+
+    measure("fenwick_file_build", n, n, [&]() {
+        ads :: Fenwick < long long > F(a, path);
+
+        F.checkpoint();
+    });
+
+    measure("fenwick_file_open", n, 1, [&]() { /// Should take the same time at every scale.
+        ads :: Fenwick < long long > F(path);
+
+        sink += F.size();
+    });
+
+    unlink(path);
+
+    return;
+}
+
+template < typename Monoid >
+    void benchSegmentTree(std :: string name, int n) {
+        /// The same workload as benchFenwick, so the sums can be compared with Fenwick.
+
+        std :: mt19937 gen(n);
+        std :: vector < long long > a(n);
+        std :: vector < std :: array < int, 4 > > q(n);
+
+        for (int i = 0; i < n; ++ i)
+            a[i] = gen() % 1000;
+
+        for (int i = 0; i < n; ++ i)
+            q[i] = {int(gen() % 2), int(gen() % n + 1), int(gen() % n + 1), int(gen() % 1000)};
+
+        ads :: SegmentTree < long long, Monoid > T(a);
+
+        measure(name, n, n, [&]() {
+            for (int i = 0; i < n; ++ i) {
+                if (q[i][0] == 0)
+                    T.Update(q[i][1], q[i][2], q[i][3]);
+                else
+                    sink += T.Query(q[i][1], q[i][2]);
+            }
+        });
+
+        return;
+    }
+
+void benchDijkstra(int n) {
+    /// A random directed graph with n vertices and 4n edges (costs between 1 and 1000). An operation = an edge.
+
+    std :: mt19937 gen(n);
+    std :: vector < std :: vector < std :: pair < long long, int > > > G(n + 1);
+
+    for (int i = 0; i < 4 * n; ++ i)
+        G[gen() % n].push_back({gen() % 1000 + 1, int(gen() % n)});
+
+    measure("dijkstra", n, 4LL * n, [&]() {
+        std :: vector < long long > dist = ads :: dijkstra(G.data(), n, 0);
+
+        sink += dist[n - 1];
+    });
+
+    std :: stringstream edges; /// The same graph, as a list of edges sorted by source.
+
+    edges << n << " " << 4LL * n << "\n";
+
+    for (int u = 0; u < n; ++ u)
+        for (int i = 0; i < G[u].size(); ++ i)
+            edges << u << " " << G[u][i].second << " " << G[u][i].first << "\n";
+
+    const char *path = "benchmark-dijkstra.csr";
+
+    ads :: csrGraph < long long > :: write(edges, path);
+
+    {
+        ads :: csrGraph < long long > C(path);
+
+        measure("dijkstra_csr", n, 4LL * n, [&]() {
+            sink += ads :: dijkstra(C, 0, 1LL << 40)[n - 1];
+        });
+
+        measure("dijkstra_csr_spilled", n, 4LL * n, [&]() { /// dist and the heap live in temporary files.
+            sink += ads :: dijkstra(C, 0, 0)[n - 1];
+        });
+    }
+
+    unlink(path);
+
+    int side = std :: sqrt(n); /// An implicit side x side grid, with the costs given by a hash of the edge.
+
+    auto grid = ads :: makeCallbackGraph < long long > (side * side, [side](int u, auto emit) {
+        int x = u / side, y = u % side;
+
+        if (x > 0)
+            emit(u - side, (u * 31LL + u - side) % 1000 + 1);
+
+        if (x + 1 < side)
+            emit(u + side, (u * 31LL + u + side) % 1000 + 1);
+
+        if (y > 0)
+            emit(u - 1, (u * 31LL + u - 1) % 1000 + 1);
+
+        if (y + 1 < side)
+            emit(u + 1, (u * 31LL + u + 1) % 1000 + 1);
+    });
+
+    measure("dijkstra_grid_callback", n, 4LL * side * (side - 1), [&]() {
+        sink += ads :: dijkstra(grid, 0, 1LL << 40)[side * side - 1];
+    });
+
+    return;
+}
+
+std :: vector < ads :: Query > connectivityLog(int Q) {
+    /// Q updates / queries on Q / 10 vertices: 40% additions, 30% removals of alive edges, 30% queries.
+
+    std :: mt19937 gen(Q);
+    std :: vector < ads :: Query > v;
+    std :: vector < std :: pair < int, int > > alive;
+
+    int V = std :: max(2, Q / 10);
+
+    for (int i = 0; i < Q; ++ i) {
+        int r = gen() % 10;
+
+        if (r < 3 && !alive.empty()) {
+            int j = gen() % alive.size();
+
+            v.push_back({'-', alive[j].first, alive[j].second});
+
+            std :: swap(alive[j], alive.back());
+            alive.pop_back();
+        }
+        else if (r < 6)
+            v.push_back({'?', int(gen() % V), int(gen() % V)});
+        else {
+            int x = gen() % V, y = gen() % V;
+
+            v.push_back({'+', x, y});
+            alive.push_back({x, y});
+        }
+    }
+
+    return v;
+}
+
+void benchConnectivity(int Q) {
+    std :: vector < ads :: Query > v = connectivityLog(Q);
+
+    measure("dynamic_connectivity", Q, Q, [&]() {
+        ads :: solver G(v);
+
+        sink += G.solve().size();
+    });
+
+    measure("dynamic_connectivity_stats", Q, Q, [&]() { /// The same, with the statistics enabled (see stats.h).
+        ads :: solver < ads :: stats > G(v);
+
+        sink += G.solve().size();
+    });
+
+    std :: stringstream in, out;
+
+    in << Q << "\n";
+
+    for (int i = 0; i < Q; ++ i)
+        in << v[i].c << " " << v[i].u << " " << v[i].v << "\n";
+
+    measure("dynamic_connectivity_chunked", Q, Q, [&]() {
+        ads :: chunkedSolver G(1 << 14);
+
+        G.solve(in, out);
+    });
+
+    sink += out.str().size();
+
+    return;
+}
+
+int main() {
+    std :: cout << "[\n";
+
+    for (int n = 10000; n <= 1000000; n *= 10) {
+        benchDsu < ads :: noStats > ("dsu", n);
+        benchDsu < ads :: stats > ("dsu_stats", n);
+    }
+
+    for (int m = 1000000; m <= 100000000; m *= 10)
+        benchComponents(m);
+
+    for (int n = 10000; n <= 1000000; n *= 10)
+        benchFenwick(n);
+
+    for (int n = 10000; n <= 1000000; n *= 10) {
+        benchSegmentTree < ads :: sumMonoid < long long > > ("segment_tree_sum", n);
+        benchSegmentTree < ads :: minMonoid < long long > > ("segment_tree_min", n);
+    }
+
+    for (int n = 10000; n <= 1000000; n *= 10)
+        benchDijkstra(n);
+
+    for (int Q = 10000; Q <= 1000000; Q *= 10)
+        benchConnectivity(Q);
+
+    std :: cout << "\n]\n";
+
+    std :: cerr << sink << "\n";
+
+    return 0;
+}
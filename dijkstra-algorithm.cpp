@@ -1,46 +1,10 @@
-/// This algorithm solves the single-source shortest path for directed graphs.
-
-/// It can be adapted for undirected graphs, by adding two edges of opposite direction between two vertices.
-
-/// How to use:
-
-/// Step 1: Construct a directed graph G with n vertices, represented as an adjacency list. Also, define a source (see line 51-63).
-/// Step 2: Save in a vector the results of dijkstra(G, n, source) (see line 65).
+/// Example driver for dijkstra (see include/ads/dijkstra.h): reads a directed graph from dijkstra.in and writes the distances from vertex 0 to dijkstra.out.
 
 #include <bits/stdc++.h>
 
-template < typename T >
-    std :: vector < T > dijkstra(std :: vector < std :: pair < T, int > > G[], int n, int source) {
-        const T INF = 1e9; /// The value of a big enough number.
-
-        std :: priority_queue < std :: pair < T, int > > heap;
-        std :: vector < T > dist(n + 1, INF);
-        std :: vector < bool > f(n + 1, false);
-
-        dist[source] = 0;
-        heap.push({-dist[source], source});
-
-        while (!heap.empty()) {
-            int u = heap.top().second;
+#include "include/ads/dijkstra.h"
 
-            if (!f[u]) {
-                f[u] = true;
-
-                for (int i = 0; i < G[u].size(); ++ i) {
-                    int cost = G[u][i].first, v = G[u][i].second;
-
-                    if (dist[v] > dist[u] + cost) { /// If working with doubles, use floating-point arithmetic.
-                        dist[v] = dist[u] + cost;
-                        heap.push({-dist[v], v});
-                    }
-                }
-            }
-
-            heap.pop();
-        }
-
-        return dist; /// If a vertex isn't reachable from the source, it will have the value of INF.
-    }
+using ads :: dijkstra;
 
 std :: ifstream fin("dijkstra.in");
 std :: ofstream fout("dijkstra.out");
@@ -1,77 +1,10 @@
-/// The following data structure solves online the following Q updates / queries in O(Q α(|V|)):
-
-/// [1]: Adds an edge in an undirected graph. If there is already an edge, the data structure ignores this update.
-/// [2]: Queries if two vertices are in the same connected component.
-
-/// How to use:
-
-/// See line 80-99.
+/// Example driver for dsu (see include/ads/dsu.h): reads the updates / queries from dsu.in and writes the answers to dsu.out.
 
 #include <bits/stdc++.h>
 
-class dsu {
-    private:
-        int n;
-        std :: vector < int > t, sz;
-        std :: stack < std :: pair < int, int > > st;
-    public:
-        dsu (int _n) {
-            /// Constructs a Disjoint Set Union data structure of size n.
-            /// Complexity: O(n).
-
-            n = _n;
-
-            for (int i = 0; i < n; ++ i) {
-                t.push_back(i);
-                sz.push_back(1);
-            }
-        }
-
-        int findRoot(int x) {
-            /// Finds the root of the tree in which x is located.
-            /// Complexity: O(α(n)).
-
-            if (t[x] == x)
-                return x;
-
-            return (t[x] = findRoot(t[x]));
-        }
-
-        bool add(int x, int y) {
-            /// Unites two trees (only if necessary). Returns true if the union happens.
-            /// Complexity: O(α(n)).
-
-            x = findRoot(x);
-            y = findRoot(y);
-
-            if (x != y) {
-                if (sz[x] < sz[y]) {
-                    t[x] = y;
-                    sz[y] += sz[x];
-                    st.push({x, y});
-                }
-                else {
-                    t[y] = x;
-                    sz[x] += sz[y];
-                    st.push({y, x});
-                }
-
-                return true;
-            }
-
-            return false;
-        }
-
-        bool query(int x, int y) {
-            /// Queries if x and y are in the same tree.
-            /// Complexity: O(α(n)).
-
-            x = findRoot(x);
-            y = findRoot(y);
+#include "include/ads/dsu.h"
 
-            return (x == y);
-        }
-};
+using ads :: dsu;
 
 std :: ifstream fin("dsu.in");
 std :: ofstream fout("dsu.out");
@@ -12,376 +12,1020 @@
 
 /// VERY IMPORTANT! The input graph must be connected and its nodes are indexed from 0.
 
+/// The restarts run in parallel on all the available threads (compile with -pthread).
+
+/// When no edge of the path can be replaced with a detour anymore, the path is improved with Posa's rotation-extension,
+/// until timeLimit seconds pass. "./hamilton-heuristic posa-bench" prints the approximation ratio reached under several time limits.
+
+/// "./hamilton-heuristic bench" runs the heuristic on seeded random graphs (some with a planted Hamiltonian path), and prints the results as CSV.
+
 #include <fstream>
 #include <iostream> /// debug
 #include <iomanip>
 
 #include <vector>
-#include <bitset>
-#include <queue>
+#include <deque>
+#include <unordered_set>
 
 #include <algorithm>
 #include <random>
 #include <chrono>
 
 #include <cmath>
+#include <climits>
+#include <string>
 
-std :: mt19937 rng(std :: chrono :: steady_clock :: now().time_since_epoch().count());
+#include <thread>
+#include <atomic>
+#include <mutex>
 
-const int dim = 1e4 + 5;
+#include "../include/ads/stats.h"
 
-int T, n, m, s, lim, res, op;
+const unsigned long long seed = 20; /// The r-th restart uses the seed (seed + r), so the results can be reproduced.
 
-std :: vector < int > path, maxPath, finalPath, G[dim], A[dim];
-std :: vector < int > t(dim), dist(dim), degree(dim);
-std :: bitset < dim > f, marked[dim];
+int budget = -1; /// The maximum number of edges a detour search may visit (-1 = no limit).
+bool longDetours = true; /// The detour searches go depth-first (long detours) or breadth-first (short detours).
 
-std :: ifstream fin("hamilton.in");
-std :: ofstream fout("hamilton.out");
+bool posa = true; /// When no detour is left, rotates / extends the path at its endpoints (Posa's rotation-extension).
+int patience = 1000; /// The number of rotations without an extension after which a restart gives up.
+bool annealing = false; /// When rotating, the endpoint may also be dropped, with probability exp(-1 / temperature).
+double temperature = 1, cooling = 0.999; /// The starting temperature, and how it decreases after every rotation.
+double timeLimit = 10; /// Seconds. After this, the improvements stop and no new restart begins.
 
-void DFS(int node) {
-    f[node] = true;
+std :: chrono :: steady_clock :: time_point deadline;
 
-    for (int i = 0; i < G[node].size(); ++ i) {
-        int u = G[node][i];
+int T, n, m, lim;
+int workers = std :: max(1, int(std :: thread :: hardware_concurrency())); /// The number of threads running restarts.
 
-        if (f[u] == false) {
-            t[u] = node;
-            DFS(u);
+std :: atomic < int > res;
+std :: atomic < long long > totalOp; /// The number of edges visited by all the detour searches.
+std :: mutex finalPathMutex;
+
+class graph {
+    /// Undirected graph, stored as a compressed sparse row adjacency (memory: O(|V| + |E|)).
+    /// The neighbours of x are adj[start[x]], ..., adj[start[x + 1] - 1], sorted increasingly,
+    /// and id[i] is the index of the edge between x and adj[i] in the input.
+
+    public:
+        int n, m;
+        std :: vector < int > start, adj, id;
+
+        graph () {
+            n = m = 0;
+            start.assign(1, 0);
         }
-    }
 
-    return;
-}
+        graph (int _n, std :: vector < std :: pair < int, int > > &edges) {
+            /// Complexity: O(|V| + |E| log |E|).
 
-bool isArtPoint(int node) {
-    int cnt = 0;
+            n = _n;
+            m = edges.size();
 
-    f[node] = true;
+            start.assign(n + 1, 0);
+            adj.resize(2 * m);
+            id.resize(2 * m);
 
-    for (int i = 0; i < n; ++ i)
-        if (f[i] == false) {
-            ++ cnt;
-            DFS(i);
-        }
+            for (int i = 0; i < m; ++ i) {
+                start[edges[i].first + 1] ++;
+                start[edges[i].second + 1] ++;
+            }
 
-    return (cnt > 1);
-}
+            for (int i = 0; i < n; ++ i)
+                start[i + 1] += start[i];
 
-void DFSTree(int node) {
-    f[node] = true;
+            std :: vector < int > pos(start.begin(), start.end() - 1);
 
-    for (int i = 0; i < A[node].size(); ++ i) {
-        int u = A[node][i];
+            for (int i = 0; i < m; ++ i) {
+                int u = edges[i].first, v = edges[i].second;
 
-        if (f[u] == false) {
-            t[u] = node;
-            dist[u] = 1 + dist[node];
-            DFSTree(u);
-        }
-    }
+                adj[pos[u]] = v;
+                id[pos[u] ++] = i;
+                adj[pos[v]] = u;
+                id[pos[v] ++] = i;
+            }
 
-    return;
-}
+            for (int x = 0; x < n; ++ x) { /// Sorts every row, so edge() can binary search it.
+                std :: vector < std :: pair < int, int > > row;
 
-void findDiameter() {
-    for (int i = 0; i < n; ++ i)
-        f[i] = false;
+                for (int i = start[x]; i < start[x + 1]; ++ i)
+                    row.push_back({adj[i], id[i]});
 
-    for (int i = 0; i < n; ++ i)
-        A[i].clear();
+                std :: sort(row.begin(), row.end());
 
-    for (int i = 0; i < n; ++ i) {
-        if (t[i] != -1) {
-            A[i].push_back(t[i]);
-            A[t[i]].push_back(i);
+                for (int i = start[x]; i < start[x + 1]; ++ i) {
+                    adj[i] = row[i - start[x]].first;
+                    id[i] = row[i - start[x]].second;
+                }
+            }
         }
-    }
 
-    dist[0] = 1;
-    DFSTree(0);
+        int degree(int x) {
+            return start[x + 1] - start[x];
+        }
 
-    int Max = 0, root, dest;
+        int edge(int x, int y) {
+            /// Returns the index of the edge between x and y, or -1 if there isn't one.
+            /// Complexity: O(log degree(x)).
 
-    for (int i = 0; i < n; ++ i)
-        if (dist[i] > Max) {
-            Max = dist[i];
-            root = i;
+            int i = std :: lower_bound(adj.begin() + start[x], adj.begin() + start[x + 1], y) - adj.begin();
+
+            if (i < start[x + 1] && adj[i] == y)
+                return id[i];
+
+            return -1;
         }
+};
 
-    for (int i = 0; i < n; ++ i)
-        f[i] = false;
+graph G;
 
-    for (int i = 0; i < n; ++ i)
-        t[i] = -1;
+std :: vector < int > finalPath, t;
 
-    dist[root] = 1;
-    DFSTree(root);
+std :: ifstream fin("hamilton.in");
+std :: ofstream fout("hamilton.out");
 
-    Max = 0;
+std :: vector < int > tin, low;
+std :: vector < std :: vector < int > > blocks;
+std :: vector < bool > isCut;
 
-    for (int i = 0; i < n; ++ i)
-        if (dist[i] > Max) {
-            Max = dist[i];
-            dest = i;
-        }
+void findBlocks() {
+    /// Tarjan's lowlink algorithm, done iteratively (deep graphs would overflow the stack otherwise).
+    /// Finds all the articulation points and all the biconnected components (blocks) in O(|V| + |E|).
 
-    while (t[dest] != -1) {
-        path.push_back(dest);
+    int timer = 0;
 
-        dest = t[dest];
-    }
+    blocks.clear();
 
-    path.push_back(root);
+    t.assign(n, -1);
+    tin.assign(n, -1);
+    low.assign(n, -1);
+    isCut.assign(n, false);
 
-    std :: reverse(path.begin(), path.end());
+    std :: vector < std :: pair < int, int > > stk; /// (vertex, position of the next neighbour to visit in G.adj)
+    std :: vector < int > st; /// The vertices of the blocks which are not found yet.
 
-    return;
-}
+    for (int root = 0; root < n; ++ root) {
+        if (tin[root] != -1)
+            continue;
 
-bool found;
+        int children = 0;
 
-void DFSUtil(int node, int x, int y) {
-    if (node == x) {
-        found = true;
-        return;
-    }
-    else {
-        if (found == false) {
-            ++ op;
+        t[root] = -1;
+        tin[root] = low[root] = timer ++;
+        stk.push_back({root, G.start[root]});
+        st.push_back(root);
+
+        while (!stk.empty()) {
+            int node = stk.back().first, i = stk.back().second;
 
-            f[node] = true;
+            if (i < G.start[node + 1]) {
+                int u = G.adj[i];
 
-            for (int i = 0; i < G[node].size(); ++ i) {
-                int u = G[node][i];
-                ++ op;
+                stk.back().second ++;
 
-                if (f[u] == false && (node != y || u != x)) {
+                if (tin[u] == -1) {
                     t[u] = node;
+                    tin[u] = low[u] = timer ++;
+                    stk.push_back({u, G.start[u]});
+                    st.push_back(u);
+                }
+                else if (u != t[node])
+                    low[node] = std :: min(low[node], tin[u]);
+
+                continue;
+            }
+
+            stk.pop_back();
 
-                    DFSUtil(u, x, y);
+            if (stk.empty())
+                break;
+
+            int p = stk.back().first;
+
+            low[p] = std :: min(low[p], low[node]);
+
+            if (low[node] >= tin[p]) { /// p separates the subtree of node from the rest of the graph.
+                if (p != root || (++ children) > 1)
+                    isCut[p] = true;
+
+                std :: vector < int > block;
+
+                while (st.back() != node) {
+                    block.push_back(st.back());
+                    st.pop_back();
                 }
+
+                block.push_back(node);
+                st.pop_back();
+                block.push_back(p);
+
+                blocks.push_back(block);
             }
         }
+
+        if (children == 0) /// An isolated vertex is a block on its own.
+            blocks.push_back(st);
+
+        st.clear();
     }
+
+    return;
 }
 
-void BFSUtil(int node, int x, int y) {
-    std :: queue < int > Q;
+std :: vector < int > heaviestChain(int &start) {
+    /// A simple path visits the blocks along a path of the block-cut tree, so the longest path lies inside the union
+    /// of the blocks of a single chain. Returns the vertices of the chain covering the most vertices, and sets start to
+    /// the articulation point in the middle of this chain (or to one of its vertices, if there is none).
+    /// Complexity: O(|V| + |E|).
 
-    f[node] = true;
-    Q.push(node);
+    int B = blocks.size();
 
-    while (!Q.empty()) {
-        if (f[x] == true)
-            break;
+    std :: vector < int > id(n, -1); /// Articulation point -> node in the block-cut tree.
+    std :: vector < int > w;
+    std :: vector < std :: vector < int > > BC;
 
-        int u = Q.front();
+    for (int i = 0; i < B; ++ i) {
+        w.push_back(blocks[i].size());
+        BC.push_back(std :: vector < int > ());
+    }
 
-        for (int i = 0; i < G[u].size(); ++ i) {
-            int v = G[u][i];
+    for (int i = 0; i < n; ++ i)
+        if (isCut[i] == true) {
+            id[i] = w.size();
+            w.push_back(-1); /// An articulation point is shared by the two neighbouring blocks of the chain.
+            BC.push_back(std :: vector < int > ());
+        }
 
-            if (f[v] == false && (u != y || v != x)) {
-                f[v] = true;
-                t[v] = u;
-                Q.push(v);
+    for (int i = 0; i < B; ++ i)
+        for (int j = 0; j < blocks[i].size(); ++ j)
+            if (id[blocks[i][j]] != -1) {
+                BC[i].push_back(id[blocks[i][j]]);
+                BC[id[blocks[i][j]]].push_back(i);
             }
+
+    int N = w.size();
+
+    std :: vector < int > order, par(N, -1), down(N), best(N, -1);
+    std :: vector < bool > seen(N, false);
+
+    for (int root = 0; root < N; ++ root) { /// Breadth-first order of the block-cut forest (one tree per connected component).
+        if (seen[root] == true)
+            continue;
+
+        seen[root] = true;
+        order.push_back(root);
+
+        for (int i = order.size() - 1; i < order.size(); ++ i)
+            for (int j = 0; j < BC[order[i]].size(); ++ j) {
+                int u = BC[order[i]][j];
+
+                if (seen[u] == false) {
+                    seen[u] = true;
+                    par[u] = order[i];
+                    order.push_back(u);
+                }
+            }
+    }
+
+    int top = -1, second = -1, heaviest = -1;
+
+    for (int i = N - 1; i >= 0; -- i) { /// down[x] = the heaviest chain that starts in x and goes down the tree.
+        int x = order[i], a = -1, b = -1;
+
+        for (int j = 0; j < BC[x].size(); ++ j) {
+            int u = BC[x][j];
+
+            if (u == par[x])
+                continue;
+
+            if (a == -1 || down[u] > down[a]) {
+                b = a;
+                a = u;
+            }
+            else if (b == -1 || down[u] > down[b])
+                b = u;
         }
 
-        Q.pop();
+        best[x] = a;
+        down[x] = w[x] + (a != -1 ? std :: max(0, down[a]) : 0);
+
+        int through = down[x] + (b != -1 ? std :: max(0, down[b]) : 0);
+
+        if (through > heaviest) {
+            heaviest = through;
+            top = x;
+            second = b;
+        }
     }
 
-    return;
+    std :: vector < int > chain;
+
+    for (int x = second; x != -1; x = best[x])
+        chain.push_back(x);
+
+    std :: reverse(chain.begin(), chain.end());
+
+    for (int x = top; x != -1; x = best[x])
+        chain.push_back(x);
+
+    std :: vector < int > cuts, vertices;
+
+    for (int i = 0; i < chain.size(); ++ i) {
+        if (chain[i] >= B)
+            cuts.push_back(chain[i]);
+        else
+            for (int j = 0; j < blocks[chain[i]].size(); ++ j)
+                vertices.push_back(blocks[chain[i]][j]);
+    }
+
+    std :: sort(vertices.begin(), vertices.end());
+    vertices.erase(std :: unique(vertices.begin(), vertices.end()), vertices.end());
+
+    start = vertices[0];
+
+    if (!cuts.empty())
+        for (int i = 0; i < n; ++ i)
+            if (id[i] == cuts[cuts.size() / 2])
+                start = i;
+
+    return vertices;
 }
 
 bool check(std :: vector < int > v) {
-    std :: vector < int > freq(dim);
-
-    for (int i = 0; i < n; ++ i)
-        freq[i] = 0;
+    std :: vector < int > freq(n, 0);
 
     for (int i = 0; i < v.size(); ++ i)
         freq[v[i]] ++;
 
-    for (int i = 0; i < v.size(); ++ i)
+    for (int i = 0; i < n; ++ i)
         if (freq[i] > 1)
             return false;
 
-    for (int i = 0; i + 1 < v.size(); ++ i) {
-        bool q = false;
+    for (int i = 0; i + 1 < v.size(); ++ i)
+        if (G.edge(v[i], v[i + 1]) == -1)
+            return false;
 
-        for (int j = 0; j < G[v[i]].size(); ++ j) {
-            int u = G[v[i]][j];
+    return true;
+}
 
-            if (u == v[i + 1]) {
-                q = true;
-                break;
+template < typename Stats >
+    class worker {
+        /// The state of one restart of the heuristic. Every thread owns a worker, so the restarts can run in parallel.
+        /// Memory: O(|V| + |E|).
+        /// With Stats = stats, also records the edges visited by every detour search, the length of the detours and the rotations (see include/ads/stats.h).
+
+        private:
+            long long op; /// The number of edges visited by the detour searches.
+            int now; /// The vertices visited by the current detour search have stamp[x] = now, so nothing is cleared between searches.
+            std :: mt19937 rng;
+            int head, tail, len;
+            double temp;
+            std :: vector < int > nxt, prv; /// The path is a doubly linked list: nxt[x] / prv[x] = the vertex after / before x, or -1.
+            std :: vector < bool > onPath;
+            std :: vector < int > t, dist, stamp;
+            std :: vector < char > side; /// 0 if a vertex was reached from x, 1 if it was reached from y.
+            std :: deque < std :: pair < int, int > > Q[2]; /// (vertex, position of the next neighbour to visit in nbr)
+            std :: vector < int > nbr; /// Every worker shuffles its own copy of G.adj.
+            std :: vector < int > treeStart, treeAdj; /// The DFS tree, stored like G.
+            std :: vector < bool > f;
+            std :: vector < bool > marked; /// marked[e] = true if no detour was found for the edge e of the path.
+        public:
+            Stats stats;
+
+            worker () {
+                nbr.resize(G.adj.size());
+                treeStart.resize(n + 1);
+                treeAdj.resize(2 * n);
+                nxt.assign(n, -1);
+                prv.assign(n, -1);
+                onPath.assign(n, false);
+                t.resize(n);
+                dist.resize(n);
+                f.resize(n);
+                stamp.assign(n, 0);
+                side.resize(n);
+                op = now = 0;
+                marked.assign(G.m, false);
             }
-        }
 
-        if (q == false)
-            return false;
-    }
+            void DFS(int x) {
+                /// Iterative, so deep graphs don't overflow the stack.
 
-    return true;
-}
+                std :: vector < std :: pair < int, int > > stk; /// (vertex, position of the next neighbour to visit in nbr)
 
-bool v;
-int maxPriority;
+                f[x] = true;
+                stk.push_back({x, G.start[x]});
 
-void extendPath(int x, int y, int index) {
-    for (int i = 0; i < n; ++ i)
-        f[i] = false;
+                while (!stk.empty()) {
+                    int node = stk.back().first, i = stk.back().second;
 
-    for (int i = 0; i < path.size(); ++ i)
-        f[path[i]] = true;
+                    if (i == G.start[node + 1]) {
+                        stk.pop_back();
+                        continue;
+                    }
 
-    for (int i = 0; i < n; ++ i)
-        t[i] = -1;
+                    stk.back().second ++;
 
-    found = false;
-    f[x] = false;
-    DFSUtil(y, x, y);
+                    int u = nbr[i];
 
-    /*************/
+                    if (f[u] == false) {
+                        f[u] = true;
+                        t[u] = node;
+                        stk.push_back({u, G.start[u]});
+                    }
+                }
 
-    if (t[x] == -1)
-        return;
+                return;
+            }
 
-    v = true;
+            int farthest(int root) {
+                /// Computes the distances (in vertices) from root in the DFS tree, and returns the farthest vertex.
 
-    /*************/
+                std :: vector < int > Q;
 
-    std :: vector < int > augm;
+                f[root] = true;
+                dist[root] = 1;
+                Q.push_back(root);
 
-    while (t[x] != -1) {
-        augm.push_back(x);
+                for (int i = 0; i < Q.size(); ++ i) {
+                    int node = Q[i];
 
-        x = t[x];
-    }
+                    for (int j = treeStart[node]; j < treeStart[node + 1]; ++ j) {
+                        int u = treeAdj[j];
 
-    augm.push_back(y);
+                        if (f[u] == false) {
+                            f[u] = true;
+                            t[u] = node;
+                            dist[u] = 1 + dist[node];
+                            Q.push_back(u);
+                        }
+                    }
+                }
 
-    std :: vector < int > newPath;
+                int Max = 0, dest = root;
 
-    for (int i = 0; i < index; ++ i)
-        newPath.push_back(path[i]);
+                for (int i = 0; i < n; ++ i)
+                    if (dist[i] > Max) {
+                        Max = dist[i];
+                        dest = i;
+                    }
 
-    for (int i = 0; i < augm.size(); ++ i)
-        newPath.push_back(augm[i]);
+                return dest;
+            }
 
-    for (int i = index + 2; i < path.size(); ++ i)
-        newPath.push_back(path[i]);
+            void findDiameter() {
+                for (int i = 0; i <= n; ++ i)
+                    treeStart[i] = 0;
 
-    path = newPath;
+                for (int i = 0; i < n; ++ i)
+                    if (t[i] != -1) {
+                        treeStart[i + 1] ++;
+                        treeStart[t[i] + 1] ++;
+                    }
 
-    return;
-}
+                for (int i = 0; i < n; ++ i)
+                    treeStart[i + 1] += treeStart[i];
 
-void solve(int x) {
-    int k = 20;
+                std :: vector < int > pos(treeStart.begin(), treeStart.end() - 1);
 
-    while (k --) {
-        for (int i = 0; i < n; ++ i)
-            std :: shuffle(G[i].begin(), G[i].end(), rng);
+                for (int i = 0; i < n; ++ i)
+                    if (t[i] != -1) {
+                        treeAdj[pos[i] ++] = t[i];
+                        treeAdj[pos[t[i]] ++] = i;
+                    }
 
-        for (int i = 0; i < n; ++ i)
-            t[i] = -1;
+                for (int i = 0; i < n; ++ i)
+                    f[i] = false;
 
-        for (int i = 0; i < n; ++ i)
-            f[i] = false;
+                int root = farthest(0);
+
+                for (int i = 0; i < n; ++ i)
+                    f[i] = false;
+
+                for (int i = 0; i < n; ++ i)
+                    t[i] = -1;
+
+                int dest = farthest(root);
+
+                head = root;
+                tail = dest;
+                len = 1;
+                onPath[root] = true;
+
+                while (t[dest] != -1) {
+                    nxt[t[dest]] = dest;
+                    prv[dest] = t[dest];
+                    onPath[dest] = true;
+                    ++ len;
+
+                    dest = t[dest];
+                }
+
+                return;
+            }
+
+            std :: vector < int > path() {
+                /// Complexity: O(len).
+
+                std :: vector < int > v;
+
+                for (int x = head; x != -1; x = nxt[x])
+                    v.push_back(x);
+
+                return v;
+            }
+
+            bool extendPath(int x, int y) {
+                /// Tries to replace the edge between x and y = nxt[x] with a detour through vertices outside the path.
+                /// The detour is searched from both x and y at the same time, one edge per step on each side, until the
+                /// two searches meet (or budget edges were visited). The detour is spliced into the linked list in O(its length).
+
+                ++ now;
+
+                stamp[x] = stamp[y] = now;
+                side[x] = 0;
+                side[y] = 1;
+
+                Q[0].clear();
+                Q[1].clear();
+                Q[0].push_back({x, G.start[x]});
+                Q[1].push_back({y, G.start[y]});
+
+                int a = -1, b = -1, ops = 0; /// The edge between the two searches: a was reached from x, b from y.
+
+                for (int s = 0; a == -1; s ^= 1) {
+                    if (Q[s].empty() || ops == budget) { /// One of the searches can't go any further.
+                        if (Stats :: enabled) {
+                            stats.record("detour search ops", ops);
+                            stats.count("detour searches failed");
+                        }
+
+                        return false;
+                    }
+
+                    std :: pair < int, int > &top = (longDetours ? Q[s].back() : Q[s].front());
+                    int node = top.first, i = top.second;
+
+                    if (i == G.start[node + 1]) {
+                        if (longDetours)
+                            Q[s].pop_back();
+                        else
+                            Q[s].pop_front();
+
+                        continue;
+                    }
+
+                    ++ top.second;
+                    ++ ops;
+                    ++ op;
+
+                    int u = nbr[i];
+
+                    if (stamp[u] == now) {
+                        if (side[u] != s && (node != x || u != y) && (node != y || u != x)) {
+                            a = (s == 0 ? node : u);
+                            b = (s == 0 ? u : node);
+                        }
+                    }
+                    else if (onPath[u] == false) {
+                        stamp[u] = now;
+                        side[u] = s;
+                        t[u] = node;
+                        Q[s].push_back({u, G.start[u]});
+                    }
+                }
+
+                std :: vector < int > detour; /// x, ..., a, b, ..., y
+
+                for (int u = a; u != x; u = t[u])
+                    detour.push_back(u);
+
+                detour.push_back(x);
+
+                std :: reverse(detour.begin(), detour.end());
+
+                for (int u = b; u != y; u = t[u])
+                    detour.push_back(u);
+
+                detour.push_back(y);
 
-        DFS(x);
+                for (int i = 0; i + 1 < detour.size(); ++ i) {
+                    nxt[detour[i]] = detour[i + 1];
+                    prv[detour[i + 1]] = detour[i];
+                }
+
+                for (int i = 1; i + 1 < detour.size(); ++ i)
+                    onPath[detour[i]] = true;
 
-        /***********************************/
+                len += detour.size() - 2;
+
+                if (Stats :: enabled) {
+                    stats.record("detour search ops", ops);
+                    stats.record("detour length", detour.size() - 2);
+                }
+
+                return true;
+            }
+
+            void clearMarks() {
+                for (int x = head; nxt[x] != -1; x = nxt[x])
+                    marked[G.edge(x, nxt[x])] = false;
 
-        for (int dest = 0; dest < n; ++ dest)
-            if (x != dest && t[dest] == -1)
                 return;
+            }
+
+            bool rotateExtend(int &bestLen, std :: vector < int > &bestPath) {
+                /// Posa's rotation-extension. If an endpoint e has a neighbour outside the path, the path is extended with it.
+                /// Otherwise, for a neighbour w of e on the path, the part of the path between w and e is reversed, so the
+                /// vertex after w becomes the new endpoint. With annealing, e may also be dropped from the path instead.
+                /// Returns true if the path changed its vertices (so the detour scan has to run again).
+                /// Complexity: O(len + degree(e)) per rotation.
+
+                for (int moves = 0; moves < patience && res != lim && std :: chrono :: steady_clock :: now() < deadline; ++ moves) {
+                    int d = (rng() & 1); /// 1 -> works on the tail, 0 -> works on the head.
+
+                    std :: vector < int > &fwd = (d ? nxt : prv), &bwd = (d ? prv : nxt); /// fwd goes towards the endpoint.
+                    int &end = (d ? tail : head), e = end;
+
+                    int k = G.start[e + 1] - G.start[e], w = -1;
+
+                    if (k == 0) /// The graph has a single vertex.
+                        return false;
+
+                    for (int i = G.start[e]; i < G.start[e + 1]; ++ i)
+                        if (onPath[nbr[i]] == false) { /// Extension.
+                            int u = nbr[i];
+
+                            fwd[e] = u;
+                            bwd[u] = e;
+                            fwd[u] = -1;
+                            end = u;
+                            onPath[u] = true;
+                            ++ len;
+
+                            if (Stats :: enabled)
+                                stats.count("posa extensions");
+
+                            return true;
+                        }
+
+                    if (annealing && bwd[e] != -1 && std :: uniform_real_distribution < double > (0, 1)(rng) < std :: exp(-1 / temp)) {
+                        if (len > bestLen) {
+                            bestLen = len;
+                            bestPath = path();
+                        }
 
-        /***********************************/
+                        int p = bwd[e];
 
-        findDiameter();
+                        marked[G.edge(p, e)] = false;
+                        fwd[p] = bwd[e] = -1;
+                        end = p;
+                        onPath[e] = false;
+                        -- len;
 
-        bool ok;
+                        clearMarks(); /// e is outside the path now, so there may be new detours.
 
-        do {
-            ok = false;
+                        return true;
+                    }
 
-            int old = path.size();
+                    temp *= cooling;
 
-            for (int index = 0; index < path.size() - 1; ++ index) {
-                int old = path.size();
+                    for (int tries = 0; tries < 4 && (w == -1 || w == bwd[e]); ++ tries) /// A random neighbour of e, other than the one before it.
+                        w = nbr[G.start[e] + rng() % k];
 
-                if (marked[path[index]][path[index + 1]] == 0)
-                    extendPath(path[index], path[index + 1], index);
+                    if (w == -1 || w == bwd[e])
+                        continue;
 
-                if (old < path.size()) {
-                    ok = true;
+                    int u = fwd[w];
 
-                    break;
+                    marked[G.edge(w, u)] = false; /// This edge leaves the path.
+
+                    for (int x = u; x != -1; ) {
+                        int y = fwd[x];
+
+                        std :: swap(nxt[x], prv[x]);
+                        x = y;
+                    }
+
+                    fwd[w] = e;
+                    bwd[e] = w;
+                    fwd[u] = -1;
+                    end = u;
+
+                    if (Stats :: enabled)
+                        stats.count("posa rotations");
                 }
-                else
-                    marked[path[index]][path[index + 1]] = marked[path[index + 1]][path[index]] = 1;
+
+                return false;
             }
-        } while (ok == true);
 
-        if (res < path.size()) {
-            res = path.size();
+            bool restart(int x, int r) {
+                /// Runs the r-th restart of the heuristic, starting the DFS from x.
+                /// Returns false if the graph isn't connected.
+
+                rng.seed(seed + r);
+
+                nbr = G.adj;
+
+                for (int i = 0; i < n; ++ i) /// Shuffles the original order, so the restart doesn't depend on the previous ones.
+                    std :: shuffle(nbr.begin() + G.start[i], nbr.begin() + G.start[i + 1], rng);
+
+                for (int i = 0; i < n; ++ i)
+                    t[i] = -1;
+
+                for (int i = 0; i < n; ++ i)
+                    f[i] = false;
+
+                DFS(x);
+
+                /***********************************/
+
+                for (int dest = 0; dest < n; ++ dest)
+                    if (x != dest && t[dest] == -1)
+                        return false;
+
+                /***********************************/
+
+                findDiameter();
+
+                int node, bestLen = 0;
+                std :: vector < int > bestPath;
+
+                temp = temperature;
+
+                do {
+                    node = head;
+
+                    while (nxt[node] != -1 && res != lim) { /// Stops if another worker has already found a path of maximum length.
+                        int e = G.edge(node, nxt[node]);
+
+                        if (marked[e] == false && extendPath(node, nxt[node]) == true) /// The edges before node can't be extended anymore, so the scan resumes from node.
+                            continue;
+
+                        marked[e] = true;
+                        node = nxt[node];
+                    }
+                } while (posa && res != lim && rotateExtend(bestLen, bestPath) == true);
+
+                if (len > bestLen) {
+                    bestLen = len;
+                    bestPath = path();
+                }
+
+                int best = res;
+
+                while (best < bestLen && !res.compare_exchange_weak(best, bestLen)); /// Shares the best length with the other workers.
+
+                if (best < bestLen) {
+                    std :: lock_guard < std :: mutex > lock(finalPathMutex);
+
+                    if (finalPath.size() < bestLen)
+                        finalPath = bestPath;
+                }
+
+                totalOp += op;
+                op = 0;
+
+                for (node = head; node != -1; ) {
+                    int u = nxt[node];
+
+                    if (u != -1)
+                        marked[G.edge(node, u)] = false;
+
+                    onPath[node] = false;
+                    nxt[node] = prv[node] = -1;
+
+                    node = u;
+                }
+
+                return true;
+            }
+    };
+
+template < typename Stats >
+    void solve(int x, Stats &stats) {
+        /// Runs k restarts of the heuristic on all the available threads, stopping once a path of length lim is found.
+        /// The r-th restart always uses the same seed, no matter which thread runs it. The statistics of the workers are added to stats.
+
+        int k = 20;
+
+        std :: atomic < int > next(0);
+        std :: atomic < bool > connected(true);
+        std :: vector < std :: thread > threads;
+        std :: mutex statsMutex;
+
+        deadline = std :: chrono :: steady_clock :: now() + std :: chrono :: duration_cast < std :: chrono :: steady_clock :: duration > (std :: chrono :: duration < double > (timeLimit));
+
+        for (int i = 0; i < std :: min(k, workers); ++ i)
+            threads.push_back(std :: thread([&]() {
+                worker < Stats > W;
+
+                for (int r = next ++; r < k && res != lim && connected; r = next ++) {
+                    if (r > 0 && std :: chrono :: steady_clock :: now() >= deadline) /// Out of time.
+                        break;
+
+                    if (W.restart(x, r) == false)
+                        connected = false;
+                }
+
+                std :: lock_guard < std :: mutex > lock(statsMutex);
+
+                stats.merge(W.stats);
+            }));
+
+        for (int i = 0; i < threads.size(); ++ i)
+            threads[i].join();
+
+        return;
+    }
+
+template < typename Stats >
+    void run(std :: vector < std :: pair < int, int > > &edges, Stats &stats) {
+        /// Runs the heuristic on the graph with n vertices and the given edges. The path is saved in finalPath, and its length in res.
+
+        std :: vector < std :: pair < int, int > > inside;
+
+        G = graph(n, edges);
 
-            finalPath = path;
+        findBlocks();
+
+        int start, N = n;
+        std :: vector < int > vertices = heaviestChain(start), label(n, -1);
+
+        for (int i = 0; i < vertices.size(); ++ i)
+            label[vertices[i]] = i;
+
+        for (int i = 0; i < m; ++ i) { /// Splits the instance: only the vertices of the heaviest chain of blocks are kept.
+            int u = label[edges[i].first], v = label[edges[i].second];
+
+            if (u != -1 && v != -1)
+                inside.push_back({u, v});
         }
 
-        for (int i = 0; i < path.size() - 1; ++ i)
-            marked[path[i]][path[i + 1]] = marked[path[i + 1]][path[i]] = 0;
+        n = vertices.size();
+        G = graph(n, inside);
+
+        int cnt = 0;
+
+        for (int i = 0; i < n; ++ i)
+            cnt += (G.degree(i) == 1);
+
+        if (cnt < 3)
+            lim = n;
+        else
+            lim = n - cnt + 2;
+
+        solve(label[start], stats);
 
-        path.clear();
+        for (int i = 0; i < finalPath.size(); ++ i) /// Restores the original instance.
+            finalPath[i] = vertices[finalPath[i]];
 
-        if (res == lim) return;
+        n = N;
+        G = graph(n, edges);
+
+        return;
     }
+
+void run(std :: vector < std :: pair < int, int > > &edges) {
+    ads :: noStats stats; /// Records nothing.
+
+    run(edges, stats);
+
+    return;
+}
+
+std :: vector < std :: pair < int, int > > generate(int N, long long M, bool planted, unsigned long long seed) {
+    /// Generates a random connected graph with N vertices and (about) M edges. If planted, the graph contains a
+    /// Hamiltonian path on a random permutation of the vertices, so the longest path is known to have N vertices.
+    /// Otherwise, it contains a random spanning tree.
+
+    std :: mt19937_64 gen(seed);
+    std :: vector < std :: pair < int, int > > edges;
+    std :: vector < int > p(N);
+    std :: unordered_set < long long > seen;
+
+    M = std :: min(M, 1LL * N * (N - 1) / 2);
+
+    for (int i = 0; i < N; ++ i)
+        p[i] = i;
+
+    std :: shuffle(p.begin(), p.end(), gen);
+
+    auto add = [&](int u, int v) {
+        if (u == v || seen.count(1LL * std :: min(u, v) * N + std :: max(u, v)) > 0)
+            return;
+
+        seen.insert(1LL * std :: min(u, v) * N + std :: max(u, v));
+        edges.push_back({u, v});
+    };
+
+    for (int i = 1; i < N; ++ i)
+        add(p[i], (planted ? p[i - 1] : p[gen() % i]));
+
+    while (edges.size() < M)
+        add(gen() % N, gen() % N);
+
+    std :: shuffle(edges.begin(), edges.end(), gen);
+
+    return edges;
+}
+
+void benchmark() {
+    /// Runs the heuristic on seeded families of random graphs, and prints (as CSV) for every graph:
+    /// the wall time, the edges visited by the detour searches, the length of the path and the approximation ratio.
+    /// Relatively sparse -> |V| log |V| edges, dense -> |V|^2 / 4 edges.
+
+    std :: cout << "family,n,m,seed,time_ms,ops,length,ratio\n";
+
+    for (int dense = 0; dense < 2; ++ dense)
+        for (int planted = 1; planted >= 0; -- planted)
+            for (int N = (dense ? 300 : 1000); N <= (dense ? 3000 : 100000); N *= (dense ? 3 : 10))
+                for (unsigned long long seed = 1; seed <= 3; ++ seed) {
+                    long long M = (dense ? 1LL * N * N / 4 : (long long)(N * std :: log2(N)));
+
+                    std :: vector < std :: pair < int, int > > edges = generate(N, M, planted, seed);
+
+                    n = N;
+                    m = edges.size();
+                    totalOp = 0;
+
+                    std :: chrono :: steady_clock :: time_point begin = std :: chrono :: steady_clock :: now();
+
+                    run(edges);
+
+                    double ms = std :: chrono :: duration < double, std :: milli > (std :: chrono :: steady_clock :: now() - begin).count();
+
+                    std :: cout << (dense ? "dense" : "sparse") << (planted ? "-planted" : "") << "," << n << "," << m << "," << seed << ","
+                                << std :: fixed << std :: setprecision(1) << ms << "," << totalOp << "," << res << ","
+                                << std :: setprecision(4) << double(n) / res << "\n";
+
+                    res = 0;
+                    finalPath.clear();
+                }
+
+    return;
 }
 
 double approximation_ratio;
 
-int main() {
+int main(int argc, char *argv[]) {
+    /// ./hamilton-heuristic posa-bench -> for every test, prints (as CSV) the approximation ratio reached under several time limits.
+    /// ./hamilton-heuristic bench -> runs the heuristic on generated graphs (see benchmark()).
+    /// ./hamilton-heuristic stats -> also prints the statistics of every test (see include/ads/stats.h).
+
+    if (argc > 1 && std :: string(argv[1]) == "bench") {
+        benchmark();
+
+        return 0;
+    }
+
+    bool bench = (argc > 1 && std :: string(argv[1]) == "posa-bench");
+
+    if (bench) {
+        patience = INT_MAX; /// Only the time limit stops the improvements.
+
+        std :: cout << "test,time_limit,length,ratio\n";
+    }
+
     fin >> T;
 
-    while (T --) { /// This algorithm is adapted to work on multiple test-cases.
+    for (int test = 1; test <= T; ++ test) { /// This algorithm is adapted to work on multiple test-cases.
         fin >> n >> m;
 
+        std :: vector < std :: pair < int, int > > edges;
+
         for (int i = 0, u, v; i < m; ++ i) {
             fin >> u >> v;
 
-            G[u].push_back(v);
-            G[v].push_back(u);
-
-            degree[u] ++;
-            degree[v] ++;
+            edges.push_back({u, v});
         }
 
-        int artPoint = 0;
+        if (bench) {
+            double limits[] = {0.01, 0.03, 0.1, 0.3, 1, 3};
 
-        for (int i = 0; i < n; ++ i) { /// Finding an articulation point can also be done in O(|V| + |E|).
-            for (int j = 0; j < n; ++ j)
-                f[j] = false;
+            for (int i = 0; i < 6; ++ i) {
+                timeLimit = limits[i];
 
-            if (isArtPoint(i) == true) {
-                artPoint = i;
-                break;
+                run(edges);
+
+                std :: cout << test << "," << limits[i] << "," << res << "," << double(n) / res << "\n";
+
+                res = 0;
+                finalPath.clear();
             }
+
+            continue;
         }
 
-        int cnt = 0;
+        if (argc > 1 && std :: string(argv[1]) == "stats") {
+            ads :: stats S;
 
-        for (int i = 0; i < n; ++ i)
-            cnt += (degree[i] == 1);
+            run(edges, S);
 
-        if (cnt < 3)
-            lim = n;
+            std :: cerr << "Test " << test << ":\n";
+            S.dump(std :: cerr);
+        }
         else
-            lim = n - cnt + 2;
-
-        solve(artPoint);
+            run(edges);
 
         fout << res << "\n";
 
@@ -401,13 +1045,11 @@ int main() {
 
         res = 0;
         finalPath.clear();
-
-        for (int i = 0; i < n; ++ i) {
-            degree[i] = 0;
-            G[i].clear();
-        }
     }
 
+    if (!bench && T > 0)
+        std :: cout << "Mean approximation ratio: " << approximation_ratio / T << "\n";
+
     return 0;
 }
 
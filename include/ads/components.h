@@ -0,0 +1,176 @@
+/// Labels the connected components of a whole undirected graph at once, in O(|V| + |E|) work (Afforest, Sutton et al. 2018),
+/// instead of passing every edge through dsu :: add.
+
+/// The graph is given in CSR format: the neighbours of u are adj[offsets[u] .. offsets[u + 1]), and every edge must appear
+/// in the lists of both its ends (toCSR builds them from a list of edges).
+
+/// The algorithm:
+/// [1]: Links every vertex with its first 2 neighbours (which usually joins most of the vertices in one big component), compressing after each round.
+/// [2]: Finds the biggest component by sampling 1024 labels.
+/// [3]: Links the rest of the edges, skipping the vertices of the biggest component (their edges will be seen from the other end).
+/// [4]: Compresses all labels, so that every vertex points directly to the root (the smallest vertex) of its component.
+
+/// The links are lock-free (compare-and-swap from the bigger root to the smaller one, with path halving), and every step runs on threads threads.
+
+/// How to use:
+
+/// std :: vector < int > label = ads :: components(n, offsets, adj);
+/// ads :: dsu T(n);
+/// T.load(label); -> T.query(u, v) and T.add(u, v) work as if every edge was added with T.add (see dsu.h).
+
+#ifndef ADS_COMPONENTS_H
+#define ADS_COMPONENTS_H
+
+#include <atomic>
+#include <random>
+#include <thread>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <unordered_map>
+
+namespace ads {
+    template < typename F >
+        void parallelFor(int n, int threads, F f) {
+            /// Calls f(i) for every 0 <= i < n, on threads threads which take blocks of 4096 consecutive indices.
+
+            const int BLOCK = 4096;
+
+            std :: atomic < int > next(0);
+
+            auto work = [&]() {
+                for (int b = next.fetch_add(BLOCK); b < n; b = next.fetch_add(BLOCK))
+                    for (int i = b, e = std :: min(n, b + BLOCK); i < e; ++ i)
+                        f(i);
+            };
+
+            std :: vector < std :: thread > pool;
+
+            for (int i = 1; i < threads; ++ i)
+                pool.emplace_back(work);
+
+            work();
+
+            for (int i = 0; i < pool.size(); ++ i)
+                pool[i].join();
+
+            return;
+        }
+
+    inline void toCSR(int n, const std :: vector < std :: pair < int, int > > &edges, std :: vector < long long > &offsets, std :: vector < int > &adj) {
+        /// Builds the CSR format of an undirected graph (every edge is put in the lists of both its ends).
+        /// Complexity: O(|V| + |E|).
+
+        offsets.assign(n + 1, 0);
+        adj.resize(2 * edges.size());
+
+        for (int i = 0; i < edges.size(); ++ i) {
+            ++ offsets[edges[i].first + 1];
+            ++ offsets[edges[i].second + 1];
+        }
+
+        for (int i = 0; i < n; ++ i)
+            offsets[i + 1] += offsets[i];
+
+        std :: vector < long long > pos(offsets.begin(), offsets.end() - 1);
+
+        for (int i = 0; i < edges.size(); ++ i) {
+            adj[pos[edges[i].first] ++] = edges[i].second;
+            adj[pos[edges[i].second] ++] = edges[i].first;
+        }
+
+        return;
+    }
+
+    inline std :: vector < int > components(int n, const std :: vector < long long > &offsets, const std :: vector < int > &adj,
+                                            int threads = std :: thread :: hardware_concurrency()) {
+        /// Returns label, where label[x] = the smallest vertex of the component of x.
+        /// Complexity: O(|V| + |E|) work (almost always), on threads threads.
+
+        const int ROUNDS = 2, SAMPLES = 1024;
+
+        std :: vector < int > comp(n);
+
+        for (int i = 0; i < n; ++ i)
+            comp[i] = i;
+
+        int *c = comp.data();
+
+        auto get = [c](int x) {
+            return __atomic_load_n(c + x, __ATOMIC_RELAXED);
+        };
+
+        auto find = [&](int x) {
+            /// Finds the root of x, pointing every other vertex on the way to its grandparent (path halving).
+
+            for (int p = get(x), g = get(p); p != g; p = get(x), g = get(p)) {
+                __atomic_compare_exchange_n(c + x, &p, g, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+                x = g;
+            }
+
+            return get(x);
+        };
+
+        auto link = [&](int u, int v) {
+            /// Joins the trees of u and v, by pointing the bigger of the two roots to the smaller one.
+
+            while (true) {
+                int p1 = find(u), p2 = find(v);
+
+                if (p1 == p2)
+                    return;
+
+                int high = std :: max(p1, p2), low = std :: min(p1, p2);
+
+                if (__atomic_compare_exchange_n(c + high, &high, low, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) /// Fails if high isn't a root anymore.
+                    return;
+            }
+        };
+
+        auto compress = [&](int u) {
+            for (int p = get(u), q = get(p); p != q; p = q, q = get(p))
+                __atomic_store_n(c + u, q, __ATOMIC_RELAXED);
+        };
+
+        threads = std :: max(threads, 1);
+
+        for (int r = 0; r < ROUNDS; ++ r) {
+            parallelFor(n, threads, [&](int u) {
+                if (offsets[u] + r < offsets[u + 1])
+                    link(u, adj[offsets[u] + r]);
+            });
+
+            parallelFor(n, threads, compress);
+        }
+
+        int big = -1; /// The most frequent label among the samples.
+
+        if (n > 0) {
+            std :: mt19937 gen(n);
+            std :: unordered_map < int, int > freq;
+
+            for (int i = 0, best = 0; i < SAMPLES; ++ i) {
+                int x = comp[gen() % n];
+
+                if (++ freq[x] > best) {
+                    best = freq[x];
+                    big = x;
+                }
+            }
+        }
+
+        parallelFor(n, threads, [&](int u) {
+            if (get(u) == big)
+                return;
+
+            for (long long i = offsets[u] + ROUNDS; i < offsets[u + 1]; ++ i)
+                link(u, adj[i]);
+        });
+
+        parallelFor(n, threads, compress);
+
+        return comp;
+    }
+}
+
+#endif
@@ -0,0 +1,192 @@
+/// This algorithm solves the single-source shortest path for directed graphs.
+
+/// It can be adapted for undirected graphs, by adding two edges of opposite direction between two vertices.
+
+/// How to use:
+
+/// Step 1: Construct a directed graph G with n vertices, represented as an adjacency list. Also, define a source (see dijkstra-algorithm.cpp).
+/// Step 2: Save in a vector the results of dijkstra(G, n, source).
+
+/// To count the stale heap entries, declare ads :: stats S and call dijkstra(G, n, source, S), then S.dump(std :: cerr) (see stats.h).
+
+/// For graphs which don't fit in memory as adjacency lists, call dijkstra(G, source, budget) where G is an adjacency provider
+/// (a graph in a CSR file, or an implicit graph, see graph.h). The distances and the heap take O(|V|) memory (never O(|E|)),
+/// and they move to memory-mapped temporary files if they need more than budget bytes.
+
+#ifndef ADS_DIJKSTRA_H
+#define ADS_DIJKSTRA_H
+
+#include <queue>
+#include <limits>
+#include <vector>
+#include <utility>
+
+#include "stats.h"
+#include "graph.h"
+
+namespace ads {
+    template < typename T, typename Stats >
+        std :: vector < T > dijkstra(std :: vector < std :: pair < T, int > > G[], int n, int source, Stats &stats) {
+            /// Same as dijkstra(G, n, source), but also counts (see stats.h) the vertices popped from the heap, the stale entries
+            /// among them (vertices which were already popped with a smaller distance) and the relaxed edges.
+
+            const T INF = 1e9; /// The value of a big enough number.
+
+            std :: priority_queue < std :: pair < T, int > > heap;
+            std :: vector < T > dist(n + 1, INF);
+            std :: vector < bool > f(n + 1, false);
+
+            dist[source] = 0;
+            heap.push({-dist[source], source});
+
+            while (!heap.empty()) {
+                int u = heap.top().second;
+
+                heap.pop(); /// Before the relaxations: a 0-cost edge pushes an entry which can tie with the top.
+
+                if (Stats :: enabled)
+                    stats.count("dijkstra pops");
+
+                if (!f[u]) {
+                    f[u] = true;
+
+                    for (int i = 0; i < G[u].size(); ++ i) {
+                        int cost = G[u][i].first, v = G[u][i].second;
+
+                        if (dist[v] > dist[u] + cost) { /// If working with doubles, use floating-point arithmetic.
+                            dist[v] = dist[u] + cost;
+                            heap.push({-dist[v], v});
+
+                            if (Stats :: enabled)
+                                stats.count("dijkstra relaxations");
+                        }
+                    }
+                }
+                else if (Stats :: enabled)
+                    stats.count("dijkstra stale pops");
+            }
+
+            return dist; /// If a vertex isn't reachable from the source, it will have the value of INF.
+        }
+
+    template < typename T >
+        std :: vector < T > dijkstra(std :: vector < std :: pair < T, int > > G[], int n, int source) {
+            noStats stats; /// Records nothing.
+
+            return dijkstra(G, n, source, stats);
+        }
+
+    template < typename Graph, typename Stats >
+        spillArray < typename Graph :: cost > dijkstra(Graph &G, int source, long long budget, Stats &stats) {
+            /// Dijkstra with an indexed binary heap (with decrease-key), so the heap has at most |V| entries. The distances (dist),
+            /// the heap and the positions in the heap (pos) are spillArrays, which share budget bytes of memory in this order.
+            /// While a vertex is relaxing its edges, the edges of the next vertex in the heap are prefetched.
+            /// Counts (see stats.h) the vertices popped from the heap, the relaxed edges and the decrease-keys.
+            /// Complexity: O((|V| + |E|) log |V|).
+
+            typedef typename Graph :: cost T;
+
+            const T INF = std :: numeric_limits < T > :: max(); /// The distance of the vertices which aren't reachable from the source.
+            const int NEW = -1, DONE = -2;
+
+            long long n = G.size();
+
+            spillArray < T > dist(n, budget, INF);
+            budget -= (dist.spilled() ? 0 : n * sizeof(T));
+
+            spillArray < int > heap(n, budget, 0);
+            budget -= (heap.spilled() ? 0 : n * sizeof(int));
+
+            spillArray < int > pos(n, budget, NEW); /// The index of a vertex in the heap, or NEW / DONE.
+
+            int cnt = 0;
+
+            auto up = [&](int i) {
+                int x = heap[i];
+                T key = dist[x];
+
+                while (i > 0 && key < dist[heap[(i - 1) >> 1]]) {
+                    heap[i] = heap[(i - 1) >> 1];
+                    pos[heap[i]] = i;
+                    i = (i - 1) >> 1;
+                }
+
+                heap[i] = x;
+                pos[x] = i;
+            };
+
+            auto down = [&](int i) {
+                int x = heap[i];
+                T key = dist[x];
+
+                while (2 * i + 1 < cnt) {
+                    int j = 2 * i + 1;
+
+                    if (j + 1 < cnt && dist[heap[j + 1]] < dist[heap[j]])
+                        ++ j;
+
+                    if (!(dist[heap[j]] < key))
+                        break;
+
+                    heap[i] = heap[j];
+                    pos[heap[i]] = i;
+                    i = j;
+                }
+
+                heap[i] = x;
+                pos[x] = i;
+            };
+
+            dist[source] = 0;
+            heap[cnt ++] = source;
+            pos[source] = 0;
+
+            while (cnt > 0) {
+                int u = heap[0];
+
+                pos[u] = DONE;
+                heap[0] = heap[-- cnt];
+
+                if (cnt > 0) {
+                    down(0);
+                    G.prefetch(heap[0]);
+                }
+
+                if (Stats :: enabled)
+                    stats.count("dijkstra pops");
+
+                T d = dist[u];
+
+                G.forEach(u, [&](int v, T cost) {
+                    if (pos[v] != DONE && d + cost < dist[v]) { /// If working with doubles, use floating-point arithmetic.
+                        dist[v] = d + cost;
+
+                        if (pos[v] == NEW) {
+                            heap[cnt] = v;
+                            up(cnt ++);
+                        }
+                        else {
+                            up(pos[v]);
+
+                            if (Stats :: enabled)
+                                stats.count("dijkstra decrease-keys");
+                        }
+
+                        if (Stats :: enabled)
+                            stats.count("dijkstra relaxations");
+                    }
+                });
+            }
+
+            return dist;
+        }
+
+    template < typename Graph >
+        spillArray < typename Graph :: cost > dijkstra(Graph &G, int source, long long budget) {
+            noStats stats; /// Records nothing.
+
+            return dijkstra(G, source, budget, stats);
+        }
+}
+
+#endif
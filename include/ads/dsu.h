@@ -0,0 +1,335 @@
+/// The following data structure solves online the following Q updates / queries in O(Q α(|V|)):
+
+/// [1]: Adds an edge in an undirected graph. If there is already an edge, the data structure ignores this update.
+/// [2]: Queries if two vertices are in the same connected component.
+
+/// How to use:
+
+/// Declare ads :: dsu T(n), then call T.add(u, v) and T.query(u, v) (see dsu.cpp).
+
+/// To label the components of a whole graph at once, see components.h.
+
+/// rollbackDsu answers the same updates / queries in O(log |V|), but can also undo the last union with rollback().
+/// parityDsu also knows the parity of the paths between two vertices (so whether a component is bipartite), and can also undo its updates.
+
+/// To find out how long the findRoot chains get, declare dsu < stats > T(n) and call T.stats.dump(std :: cerr) (see stats.h).
+
+#ifndef ADS_DSU_H
+#define ADS_DSU_H
+
+#include <stack>
+#include <vector>
+#include <utility>
+
+#include "stats.h"
+
+namespace ads {
+    template < typename Stats = noStats >
+        class dsu {
+            private:
+                int n;
+                std :: vector < int > t, sz;
+                std :: stack < std :: pair < int, int > > st;
+
+                int chain(int x) {
+                    /// The number of edges between x and the root of its tree.
+
+                    int len = 0;
+
+                    for (; t[x] != x; x = t[x])
+                        ++ len;
+
+                    return len;
+                }
+            public:
+                Stats stats; /// Records the length of the findRoot chains in add / query (see stats.h).
+
+                dsu (int _n) {
+                    /// Constructs a Disjoint Set Union data structure of size n.
+                    /// Complexity: O(n).
+
+                    n = _n;
+
+                    for (int i = 0; i < n; ++ i) {
+                        t.push_back(i);
+                        sz.push_back(1);
+                    }
+                }
+
+                void load(const std :: vector < int > &parent) {
+                    /// Replaces the trees with the ones given by parent (e.g. the labels computed by components(), see components.h),
+                    /// so add / query can continue from them. The roots must have parent[x] = x.
+                    /// Complexity: O(n).
+
+                    n = parent.size();
+                    t = parent;
+                    sz.assign(n, 0);
+                    st = std :: stack < std :: pair < int, int > > ();
+
+                    for (int i = 0; i < n; ++ i)
+                        ++ sz[findRoot(i)];
+
+                    return;
+                }
+
+                int findRoot(int x) {
+                    /// Finds the root of the tree in which x is located.
+                    /// Complexity: O(α(n)).
+
+                    if (t[x] == x)
+                        return x;
+
+                    return (t[x] = findRoot(t[x]));
+                }
+
+                bool add(int x, int y) {
+                    /// Unites two trees (only if necessary). Returns true if the union happens.
+                    /// Complexity: O(α(n)).
+
+                    if (Stats :: enabled) {
+                        stats.record("dsu findRoot chain", chain(x));
+                        stats.record("dsu findRoot chain", chain(y));
+                    }
+
+                    x = findRoot(x);
+                    y = findRoot(y);
+
+                    if (x != y) {
+                        if (sz[x] < sz[y]) {
+                            t[x] = y;
+                            sz[y] += sz[x];
+                            st.push({x, y});
+                        }
+                        else {
+                            t[y] = x;
+                            sz[x] += sz[y];
+                            st.push({y, x});
+                        }
+
+                        return true;
+                    }
+
+                    return false;
+                }
+
+                void prefetch(int x) {
+                    /// A hint that x will be used soon: starts loading its parent in the cache.
+
+                    __builtin_prefetch(t.data() + x);
+
+                    return;
+                }
+
+                bool query(int x, int y) {
+                    /// Queries if x and y are in the same tree.
+                    /// Complexity: O(α(n)).
+
+                    if (Stats :: enabled) {
+                        stats.record("dsu findRoot chain", chain(x));
+                        stats.record("dsu findRoot chain", chain(y));
+                    }
+
+                    x = findRoot(x);
+                    y = findRoot(y);
+
+                    return (x == y);
+                }
+        };
+
+    class rollbackDsu {
+        /// The same Disjoint Set Union data structure, without path compression, so it also allows undos / rollbacks!
+        /// Used by solver (see dynamic-connectivity.h).
+
+        private:
+            int n;
+            std :: vector < int > t, sz;
+            std :: stack < std :: pair < int, int > > st;
+        public:
+            rollbackDsu (int _n) {
+                /// Constructs a Disjoint Set Union data structure of size n.
+                /// Complexity: O(n).
+
+                n = _n;
+
+                for (int i = 0; i < n; ++ i) {
+                    t.push_back(i);
+                    sz.push_back(1);
+                }
+            }
+
+            int findRoot(int x) {
+                /// Finds the root of the tree in which x is located.
+                /// Complexity: O(log n).
+
+                while (t[x] != x)
+                    x = t[x];
+
+                return x;
+            }
+
+            bool add(int x, int y) {
+                /// Unites two trees (only if necessary). Returns true if the union happens.
+                /// Complexity: O(log n).
+
+                x = findRoot(x);
+                y = findRoot(y);
+
+                if (x != y) {
+                    if (sz[x] < sz[y]) {
+                        t[x] = y;
+                        sz[y] += sz[x];
+                        st.push({x, y});
+                    }
+                    else {
+                        t[y] = x;
+                        sz[x] += sz[y];
+                        st.push({y, x});
+                    }
+
+                    return true;
+                }
+
+                return false;
+            }
+
+            bool query(int x, int y) {
+                /// Queries if x and y are in the same tree.
+                /// Complexity: O(log n).
+
+                x = findRoot(x);
+                y = findRoot(y);
+
+                return (x == y);
+            }
+
+            void rollback() {
+                /// Undos the last useful update in the data structure.
+                /// Complexity: O(1).
+
+                if (st.empty())
+                    return;
+
+                int x = st.top().first, y = st.top().second;
+                t[x] = x;
+                sz[y] -= sz[x];
+                st.pop();
+
+                return;
+            }
+    };
+
+    class parityDsu {
+        /// A rollbackDsu which also keeps the parity of every vertex relative to the root of its tree. A tree is "odd" if its
+        /// component has an odd cycle (it isn't bipartite). Can be used with timeline (see dynamic-connectivity.h).
+
+        private:
+            struct change {
+                int x, y; /// x was attached to the root y, or x = -1 if y became odd.
+                bool odd; /// The old value of odd[y].
+            };
+
+            int n;
+            std :: vector < int > t, sz;
+            std :: vector < bool > parity, odd; /// parity[x] = the parity of the edge between x and t[x].
+            std :: stack < change > st;
+
+            int findRoot(int x, int &p) {
+                /// Finds the root of the tree of x, and the parity p of the path between x and the root.
+                /// Complexity: O(log n).
+
+                p = 0;
+
+                while (t[x] != x) {
+                    p ^= parity[x];
+                    x = t[x];
+                }
+
+                return x;
+            }
+        public:
+            parityDsu (int _n) {
+                /// Complexity: O(n).
+
+                n = _n;
+
+                t.resize(n);
+                sz.assign(n, 1);
+                parity.assign(n, false);
+                odd.assign(n, false);
+
+                for (int i = 0; i < n; ++ i)
+                    t[i] = i;
+            }
+
+            bool add(int x, int y) {
+                /// Adds the edge (x, y). Returns true if the data structure changes (a union, or a component becomes odd).
+                /// Complexity: O(log n).
+
+                int px, py;
+
+                x = findRoot(x, px);
+                y = findRoot(y, py);
+
+                if (x == y) {
+                    if (px != py || odd[y])
+                        return false;
+
+                    st.push({-1, y, false});
+                    odd[y] = true;
+
+                    return true;
+                }
+
+                if (sz[x] > sz[y]) /// Attaches the smaller tree to the bigger one.
+                    std :: swap(x, y);
+
+                st.push({x, y, odd[y]});
+
+                t[x] = y;
+                sz[y] += sz[x];
+                parity[x] = (px == py); /// The new edge joins two vertices of different colors.
+                odd[y] = (odd[y] || odd[x]);
+
+                return true;
+            }
+
+            int query(int x, int y) {
+                /// Returns 0 if all the paths between x and y have an even length, 1 if all of them have an odd length,
+                /// and -1 if x and y are in different components, or if their component is odd.
+                /// Complexity: O(log n).
+
+                int px, py;
+
+                x = findRoot(x, px);
+                y = findRoot(y, py);
+
+                if (x != y || odd[x])
+                    return -1;
+
+                return (px ^ py);
+            }
+
+            void rollback() {
+                /// Undos the last update which changed the data structure.
+                /// Complexity: O(1).
+
+                if (st.empty())
+                    return;
+
+                change c = st.top();
+                st.pop();
+
+                if (c.x != -1) {
+                    t[c.x] = c.x;
+                    sz[c.y] -= sz[c.x];
+                    parity[c.x] = false;
+                }
+
+                odd[c.y] = c.odd;
+
+                return;
+            }
+    };
+}
+
+#endif
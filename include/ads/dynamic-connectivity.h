@@ -0,0 +1,348 @@
+/// The following data structure solves offline the following Q updates / queries in O(Q log^2 |V|):
+
+/// [1]: Adds an edge in an undirected graph. If there is already an edge, the data structure ignores this update.
+/// [2]: Removes an existing edge in an undirected graph. If there isn't an edge, the data structure ignores this update.
+/// [3]: Queries if two vertices are in the same connected component.
+
+/// How to use:
+
+/// Step 1: Declare a solver G which takes as a parameter a vector of updates / queries (see dynamic-connectivity.cpp).
+/// Step 2: Save all results in another vector that takes the values of G.solve().
+
+/// If the updates / queries don't fit in memory, declare instead a chunkedSolver G(window) and call G.solve(fin, fout),
+/// which reads the log in windows of the given size and writes the answers while reading.
+
+/// The "life-spans" are replayed on a rollbackDsu (see dsu.h). The same engine works with any state which can undo its updates:
+/// declare timeline < State > G(v) instead of solver G(v), where State has:
+
+/// State(n) -> the state of a graph with n vertices and no edges.
+/// add(u, v) -> adds the edge (u, v). Returns true if the state changed, so rollback() has to be called later.
+/// rollback() -> undoes the last add() which changed the state.
+/// query(u, v) -> the answer of a "?" query, as an int.
+
+/// For example, timeline < parityDsu > G(v) answers, for every "? u v", the parity of the paths between u and v (see dsu.h).
+
+/// To find out in how many nodes the "life-spans" of the edges are divided, declare solver < stats > G(v) and call G.stats.dump(std :: cerr) after G.solve() (see stats.h).
+
+#ifndef ADS_DYNAMIC_CONNECTIVITY_H
+#define ADS_DYNAMIC_CONNECTIVITY_H
+
+#include <map>
+#include <set>
+#include <vector>
+#include <istream>
+#include <ostream>
+#include <utility>
+#include <algorithm>
+#include <unordered_map>
+
+#include "dsu.h"
+
+namespace ads {
+    struct Query {
+        char c; /// Can take the following symbols: "+", "-", "?".
+        int u, v;
+
+        /// + u v -> adds an edge between u and v
+        /// - u v -> removes an edge between u and v
+        /// ? u v -> queries if u and v are in the same connected component
+    };
+
+    struct TreeUpdate {
+        /// Updates for the tree in timeline class.
+
+        int x, y, u, v;
+    };
+
+    struct Edge {
+        /// Edges for undirected graphs.
+
+        int u, v;
+    };
+
+    template < typename State, typename Stats = noStats >
+        class timeline {
+            private:
+                int n, Max; /// n = Q = the number of updates / queries.
+                std :: vector < std :: vector < Edge > > tree;
+                std :: vector < TreeUpdate > q;
+                std :: vector < Query > f;
+                std :: vector < int > ans;
+                std :: map < std :: pair < int, int >, int > M;
+                int pieces; /// The number of nodes the current "life-span" was divided in.
+            public:
+                Stats stats; /// Records the number of nodes every "life-span" is divided in, and the unions done by DFS (see stats.h).
+
+                void Update(int node, int l, int r, TreeUpdate p) {
+                    /// Updates the nodes in the solving tree.
+                    /// Complexity: O(log n).
+
+                    if (r < p.x || p.y < l)
+                        return;
+
+                    if (p.x <= l && r <= p.y) { /// Using this technique, the segment tree data structure (tree) divides the "life-span" of an edge in O(log n) intervals.
+                        tree[node].push_back({p.u, p.v});
+
+                        if (Stats :: enabled)
+                            ++ pieces;
+
+                        return;
+                    }
+
+                    int mid = ((l + r) >> 1);
+
+                    Update(node * 2 + 1, l, mid, p);
+                    Update(node * 2 + 2, mid + 1, r, p);
+
+                    return;
+                }
+
+                void DFS(State &T, int node, int l, int r) {
+                    if (l > r)
+                        return;
+
+                    int cnt = 0;
+
+                    for (int i = 0; i < tree[node].size(); ++ i) /// Updates the state (e.g. the Disjoint Set Union data structure).
+                        cnt += T.add(tree[node][i].u, tree[node][i].v);
+
+                    if (Stats :: enabled)
+                        stats.count("solver unions", cnt);
+
+                    if (l == r && f[l].c == '?')
+                        ans.push_back(T.query(f[l].u, f[l].v));
+
+                    int mid = ((l + r) >> 1);
+
+                    if (l < r) {
+                        DFS(T, 2 * node + 1, l, mid); /// Solves the problem recursively, using the edges added along the way.
+                        DFS(T, 2 * node + 2, mid + 1, r); ///
+                    }
+
+                    while (cnt --) /// Removes all the edges, because we are about to return to an earlier stage (in which every edge we added earlier doesn't exist anymore).
+                        T.rollback();
+
+                    return;
+                }
+
+                timeline (std :: vector < Query > v) {
+                    /// Constructs the tree of updates / queries (in which it propagates information).
+                    /// Complexity: O(n log n).
+
+                    n = v.size();
+
+                    f = v;
+
+                    Max = 0;
+
+                    for (int i = 0; i < n; ++ i) { /// Finds the "life-span" of every edge in the input.
+                        Max = std :: max(Max, std :: max(v[i].u, v[i].v));
+
+                        std :: pair < int, int > e = {std :: min(v[i].u, v[i].v), std :: max(v[i].u, v[i].v)}; /// The same key for (u, v) and (v, u).
+
+                        if (v[i].c == '+' && M.count(e) == 0)
+                            M[e] = i;
+
+                        if (v[i].c == '-' && M.count(e) > 0) {
+                            q.push_back({M[e], i, e.first, e.second});
+                            M.erase(e);
+                        }
+                    }
+
+                    for (std :: map < std :: pair < int, int >, int > :: iterator it = M.begin(); it != M.end(); ++ it) /// Some edges aren't removed, so they become "immortal".
+                        q.push_back({it -> second, n - 1, (it -> first).first, (it -> first).second});
+
+                    build();
+                }
+
+                timeline (std :: vector < Query > v, std :: vector < TreeUpdate > lifeSpans) {
+                    /// Constructs the tree of updates / queries, when the "life-span" of every edge is already known.
+                    /// Only the queries of v are used, the "+" / "-" symbols are ignored.
+                    /// Complexity: O(n log n).
+
+                    n = v.size();
+
+                    f = v;
+                    q = lifeSpans;
+
+                    Max = 0;
+
+                    for (int i = 0; i < n; ++ i)
+                        if (v[i].c == '?')
+                            Max = std :: max(Max, std :: max(v[i].u, v[i].v));
+
+                    for (int i = 0; i < q.size(); ++ i)
+                        Max = std :: max(Max, std :: max(q[i].u, q[i].v));
+
+                    build();
+                }
+
+                void build() {
+                    /// Propagates the "life-spans" of the edges in the tree.
+                    /// Complexity: O(n log n).
+
+                    for (int i = 0; i < 4 * n; ++ i) {
+                        std :: vector < Edge > w;
+
+                        tree.push_back(w);
+                    }
+
+                    for (int i = 0; i < q.size(); ++ i) { /// Propagates information in the "life-span" intervals of the edges.
+                        pieces = 0;
+
+                        Update(0, 0, n - 1, q[i]);
+
+                        if (Stats :: enabled)
+                            stats.record("solver Update fan-out", pieces);
+                    }
+
+                    return;
+                }
+
+                std :: vector < int > solve() {
+                    /// Solves the problem.
+                    /// Complexity: O(n log n) calls of add() / rollback(), so O(n log n log |V|) for rollbackDsu.
+
+                    State T(Max + 1);
+
+                    DFS(T, 0, 0, n - 1);
+
+                    return ans;
+                }
+        };
+
+    template < typename Stats = noStats >
+        class solver : public timeline < rollbackDsu, Stats > {
+            /// The connectivity queries: timeline over a rollbackDsu.
+
+            public:
+                solver (std :: vector < Query > v) : timeline < rollbackDsu, Stats > (v) {}
+                solver (std :: vector < Query > v, std :: vector < TreeUpdate > lifeSpans) : timeline < rollbackDsu, Stats > (v, lifeSpans) {}
+        };
+
+    class chunkedSolver {
+        /// Solves the same problem as solver, but for logs of updates / queries that don't fit in memory.
+        /// The log is read in windows of a fixed size. The edges that stay alive during a whole window are contracted with a Disjoint Set Union
+        /// data structure, so every window is solved by a small solver whose vertices are the representatives of the contracted components.
+        /// The answers are written as soon as their window is solved.
+        /// Memory: O(window + |V| + the number of alive edges), instead of O(Q log Q).
+
+        private:
+            int window, Max;
+            std :: set < std :: pair < int, int > > alive; /// The edges which are alive at the beginning of the current window.
+        public:
+            chunkedSolver (int _window) {
+                window = _window;
+                Max = 0;
+            }
+
+            void solveWindow(std :: vector < Query > &w, std :: ostream &out) {
+                /// Solves a window of updates / queries and writes its answers.
+                /// Complexity: O(|w| log |w| log |V| + (|V| + the number of alive edges) log |V|).
+
+                int k = w.size();
+
+                std :: map < std :: pair < int, int >, int > added; /// Edges added in this window -> the moment they were added.
+                std :: map < std :: pair < int, int >, int > removed; /// Edges alive before this window -> the moment they were removed.
+                std :: vector < TreeUpdate > lifeSpans;
+
+                for (int i = 0; i < k; ++ i) { /// Finds the "life-span" of every edge inside the window.
+                    Max = std :: max(Max, std :: max(w[i].u, w[i].v));
+
+                    std :: pair < int, int > e = {std :: min(w[i].u, w[i].v), std :: max(w[i].u, w[i].v)};
+                    bool before = (alive.count(e) > 0 && removed.count(e) == 0);
+
+                    if (w[i].c == '+' && !before && added.count(e) == 0)
+                        added[e] = i;
+
+                    if (w[i].c == '-') {
+                        if (added.count(e) > 0) {
+                            lifeSpans.push_back({added[e], i, e.first, e.second});
+                            added.erase(e);
+                        }
+                        else if (before) {
+                            lifeSpans.push_back({0, i, e.first, e.second}); /// This edge was alive since the beginning of the window.
+                            removed[e] = i;
+                        }
+                    }
+                }
+
+                for (std :: map < std :: pair < int, int >, int > :: iterator it = added.begin(); it != added.end(); ++ it) /// Edges that survive the window.
+                    lifeSpans.push_back({it -> second, k - 1, (it -> first).first, (it -> first).second});
+
+                rollbackDsu T(Max + 1);
+
+                for (std :: set < std :: pair < int, int > > :: iterator it = alive.begin(); it != alive.end(); ++ it) /// Contracts the edges alive during the whole window.
+                    if (removed.count(*it) == 0)
+                        T.add(it -> first, it -> second);
+
+                std :: unordered_map < int, int > id; /// Representative -> vertex in the contracted graph.
+
+                auto relabel = [&](int x) {
+                    x = T.findRoot(x);
+
+                    if (id.count(x) == 0) {
+                        int sz = id.size();
+                        id[x] = sz;
+                    }
+
+                    return id[x];
+                };
+
+                for (int i = 0; i < k; ++ i) {
+                    if (w[i].c == '?') {
+                        w[i].u = relabel(w[i].u);
+                        w[i].v = relabel(w[i].v);
+                    }
+                }
+
+                for (int i = 0; i < lifeSpans.size(); ++ i) {
+                    lifeSpans[i].u = relabel(lifeSpans[i].u);
+                    lifeSpans[i].v = relabel(lifeSpans[i].v);
+                }
+
+                solver G(w, lifeSpans);
+
+                std :: vector < int > ans = G.solve();
+
+                for (int i = 0; i < ans.size(); ++ i)
+                    out << ans[i] << "\n";
+
+                for (std :: map < std :: pair < int, int >, int > :: iterator it = removed.begin(); it != removed.end(); ++ it) /// Carries the alive edges to the next window.
+                    alive.erase(it -> first);
+
+                for (std :: map < std :: pair < int, int >, int > :: iterator it = added.begin(); it != added.end(); ++ it)
+                    alive.insert(it -> first);
+
+                return;
+            }
+
+            void solve(std :: istream &in, std :: ostream &out) {
+                /// Reads the number of updates / queries and the updates / queries from in, and writes the answers to out.
+                /// Complexity: O(Q log window log |V| + (Q / window) (|V| + the number of alive edges) log |V|).
+
+                int Q;
+                std :: vector < Query > w;
+
+                in >> Q;
+
+                while (Q --) {
+                    char c;
+                    int x, y;
+
+                    in >> c >> x >> y;
+
+                    w.push_back({c, x, y});
+
+                    if (w.size() == window || Q == 0) {
+                        solveWindow(w, out);
+                        w.clear();
+                    }
+                }
+
+                return;
+            }
+    };
+}
+
+#endif
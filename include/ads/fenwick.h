@@ -0,0 +1,346 @@
+/// This data structures applies the following updates / queries online on a vector, in O(log n) time:
+
+/// [1] : Efficiently adds a value C to all elements situated on a contiguous subarray [x, y].
+/// [2] : Queries what's the sum of all elements on a contiguous subarray [x, y].
+
+/// How to use:
+
+/// Declare ads :: Fenwick < T > A(v), then call A.Update(x, y, C) and A.Query(x, y) (see fenwick.cpp).
+
+/// The trees can also live in a memory-mapped file, so a restart doesn't have to rebuild them:
+
+/// ads :: Fenwick < T > A(v, "aib.bin") -> builds the trees from v in a new file.
+/// ads :: Fenwick < T > A("aib.bin") -> opens the file in O(1), checking its header (n, the type of the elements and the clean flag).
+/// The updates are written in place. A.checkpoint() waits until they reach the disk (msync), and so does the destructor.
+
+/// The header has a clean flag, set only after all the trees reached the disk (after the build, by checkpoint() and by the destructor),
+/// and cleared on the disk before the first update which follows. A file whose writer died in the middle of the build or of
+/// some updates isn't clean, so opening it throws instead of returning wrong sums.
+
+/// VERY IMPORTANT! Only works if you are working on 1-indexed vector.
+
+#ifndef ADS_FENWICK_H
+#define ADS_FENWICK_H
+
+#include <vector>
+#include <climits>
+#include <cstddef>
+#include <cstring>
+#include <utility>
+#include <stdexcept>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace ads {
+    struct fenwickHeader {
+        /// The first 64 bytes of a file-backed Fenwick tree. AIB1 and AIB2 follow it, each with n + 1 elements.
+
+        char magic[8];
+        long long n;
+        int size, type; /// sizeof(T) and whether T is unsigned (0), signed (1) or floating-point (2).
+        int clean; /// 1 if the trees in the file are complete (see the beginning of this file).
+        char padding[36];
+    };
+
+    template < typename T >
+        class Fenwick {
+            private:
+                int n;
+                T *AIB1, *AIB2; /// AIB1 = data, AIB2 = data + n + 1, where data is memory or the mapped file.
+                std :: vector < T > memory;
+                void *mapping;
+                size_t mappingSize;
+                bool dirty; /// Whether the file may differ from the disk (its clean flag is cleared). Always true in memory, so Update never touches a header.
+
+                static fenwickHeader header(int n) {
+                    fenwickHeader h;
+
+                    memset(&h, 0, sizeof(h));
+                    memcpy(h.magic, "FENWICK", 8);
+                    h.n = n;
+                    h.size = sizeof(T);
+                    h.type = (std :: is_floating_point < T > :: value ? 2 : std :: is_signed < T > :: value ? 1 : 0);
+
+                    return h;
+                }
+
+                void setClean(int clean) {
+                    /// Writes the clean flag of the file and waits until it reaches the disk.
+
+                    ((fenwickHeader *)mapping) -> clean = clean;
+
+                    if (msync(mapping, sizeof(fenwickHeader), MS_SYNC) == -1)
+                        throw std :: runtime_error("Fenwick: msync failed");
+
+                    return;
+                }
+
+                void map(const char *path, bool create, int _n) {
+                    /// Maps the file (creating it with room for n elements if create is set) and points AIB1 / AIB2 inside it.
+
+                    int fd = open(path, create ? (O_RDWR | O_CREAT | O_TRUNC) : O_RDWR, 0644);
+
+                    if (fd == -1)
+                        throw std :: runtime_error(std :: string("Fenwick: cannot open ") + path);
+
+                    fenwickHeader h;
+
+                    if (create) {
+                        h = header(_n);
+                        mappingSize = sizeof(fenwickHeader) + 2 * (size_t(_n) + 1) * sizeof(T);
+
+                        if (ftruncate(fd, mappingSize) == -1) {
+                            close(fd);
+                            throw std :: runtime_error(std :: string("Fenwick: cannot resize ") + path);
+                        }
+                    }
+                    else {
+                        struct stat st;
+
+                        if (fstat(fd, &st) == -1 || st.st_size < (off_t)sizeof(fenwickHeader) || pread(fd, &h, sizeof(h), 0) != sizeof(h)) {
+                            close(fd);
+                            throw std :: runtime_error(std :: string("Fenwick: cannot read the header of ") + path);
+                        }
+
+                        fenwickHeader expected = header(h.n < 0 || h.n > INT_MAX - 1 ? 0 : h.n);
+
+                        expected.clean = h.clean;
+
+                        if (memcmp(&h, &expected, sizeof(h)) != 0 || st.st_size != (off_t)(sizeof(fenwickHeader) + 2 * (size_t(h.n) + 1) * sizeof(T))) {
+                            close(fd);
+                            throw std :: runtime_error(std :: string("Fenwick: ") + path + " doesn't hold a Fenwick tree of this type");
+                        }
+
+                        if (h.clean != 1) {
+                            close(fd);
+                            throw std :: runtime_error(std :: string("Fenwick: ") + path + " wasn't saved completely (its writer stopped during a build or an update)");
+                        }
+
+                        mappingSize = st.st_size;
+                    }
+
+                    mapping = mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+                    close(fd); /// The mapping keeps the file open.
+
+                    if (mapping == MAP_FAILED) {
+                        mapping = nullptr;
+                        throw std :: runtime_error(std :: string("Fenwick: cannot map ") + path);
+                    }
+
+                    if (create)
+                        memcpy(mapping, &h, sizeof(h)); /// Not clean until the trees are built and saved.
+
+                    dirty = create;
+                    n = h.n;
+                    AIB1 = (T *)((char *)mapping + sizeof(fenwickHeader));
+                    AIB2 = AIB1 + n + 1;
+
+                    return;
+                }
+
+                void build(const std :: vector < T > &v) {
+                    /// Same trees as calling Update(i, i, v[i - 1]) for every i, but in O(n): every position starts with its difference
+                    /// from the previous one, then pushes its partial sum to its parent.
+
+                    AIB1[0] = AIB2[0] = 0;
+
+                    for (int i = 1; i <= n; ++ i) {
+                        AIB1[i] = v[i - 1] - (i > 1 ? v[i - 2] : 0);
+                        AIB2[i] = i * AIB1[i];
+                    }
+
+                    for (int i = 1; i <= n; ++ i) {
+                        int j = i + (i & (- i));
+
+                        if (j <= n) {
+                            AIB1[j] += AIB1[i];
+                            AIB2[j] += AIB2[i];
+                        }
+                    }
+
+                    return;
+                }
+            public:
+                T query1(int pos) {
+                    if (pos == 0)
+                        return 0;
+
+                    T ret = 0;
+
+                    for (int i = pos; i >= 1; i -= (i & (- i)))
+                        ret += AIB1[i];
+
+                    return ret;
+                }
+
+                T query2(int pos) {
+                    if (pos == 0)
+                        return 0;
+
+                    T ret = 0;
+
+                    for (int i = pos; i >= 1; i -= (i & (- i)))
+                        ret += AIB2[i];
+
+                    return ret;
+                }
+
+                void update1(int pos, T val) {
+                    for (int i = pos; i <= n; i += (i & (- i)))
+                        AIB1[i] += val;
+
+                    return;
+                }
+
+                void update2(int pos, T val) {
+                    for (int i = pos; i <= n; i += (i & (- i)))
+                        AIB2[i] += val;
+
+                    return;
+                }
+
+                void Update(int x, int y, T val) {
+                    if (!dirty) { /// The first update after a checkpoint.
+                        setClean(0);
+                        dirty = true;
+                    }
+
+                    if (x > y)
+                        std :: swap(x, y);
+
+                    update1(x, +val);
+                    update1(y + 1, -val);
+
+                    update2(x, +x * val);
+                    update2(y + 1, -(y + 1) * val);
+
+                    return;
+                }
+
+                T Query(int x, int y) {
+                    if (x > y)
+                        std :: swap(x, y);
+
+                    T A = (y + 1) * query1(y) - query2(y);
+                    T B = (x) * query1(x - 1) - query2(x - 1);
+
+                    return (A - B);
+                }
+
+                void prefetch(int x, int y) {
+                    /// A hint that Query(x, y) or Update(x, y, val) will be called soon: starts loading the first positions they use in the cache.
+
+                    if (x > y)
+                        std :: swap(x, y);
+
+                    __builtin_prefetch(AIB1 + x - 1);
+                    __builtin_prefetch(AIB2 + x - 1);
+                    __builtin_prefetch(AIB1 + y);
+                    __builtin_prefetch(AIB2 + y);
+
+                    return;
+                }
+
+                void checkpoint(bool wait = true) {
+                    /// Writes the updates of a file-backed tree to the disk, then marks the file clean. If wait is false, only schedules
+                    /// the writes, and the file stays not clean (until the next checkpoint() or the destructor).
+                    /// Complexity: O(the number of modified pages).
+
+                    if (mapping == nullptr)
+                        return;
+
+                    if (msync(mapping, mappingSize, wait ? MS_SYNC : MS_ASYNC) == -1)
+                        throw std :: runtime_error("Fenwick: msync failed");
+
+                    if (wait && dirty) { /// The clean flag reaches the disk only after the trees.
+                        setClean(1);
+                        dirty = false;
+                    }
+
+                    return;
+                }
+
+                int size() {
+                    return n;
+                }
+
+                Fenwick (std :: vector < T > v) {
+                    /// Builds the trees in memory.
+                    /// Complexity: O(n).
+
+                    n = v.size();
+                    mapping = nullptr;
+                    mappingSize = 0;
+                    dirty = true;
+
+                    memory.assign(2 * (n + 1), 0);
+                    AIB1 = memory.data();
+                    AIB2 = AIB1 + n + 1;
+
+                    build(v);
+                }
+
+                Fenwick (const std :: vector < T > &v, const char *path) {
+                    /// Builds the trees in a new file (an existing file is overwritten), and saves them (see checkpoint()).
+                    /// Complexity: O(n).
+
+                    mapping = nullptr;
+
+                    map(path, true, v.size());
+                    build(v);
+                    checkpoint();
+                }
+
+                Fenwick (const char *path) {
+                    /// Opens the trees saved in a file.
+                    /// Complexity: O(1) (the pages are read from the disk when they are first used).
+
+                    mapping = nullptr;
+
+                    map(path, false, 0);
+                }
+
+                Fenwick (const Fenwick &other) {
+                    /// Copies the trees in memory (even if other is file-backed).
+
+                    n = other.n;
+                    mapping = nullptr;
+                    mappingSize = 0;
+                    dirty = true;
+
+                    memory.assign(other.AIB1, other.AIB1 + 2 * (n + 1));
+                    AIB1 = memory.data();
+                    AIB2 = AIB1 + n + 1;
+                }
+
+                Fenwick & operator = (Fenwick other) {
+                    std :: swap(n, other.n);
+                    std :: swap(AIB1, other.AIB1);
+                    std :: swap(AIB2, other.AIB2);
+                    std :: swap(memory, other.memory);
+                    std :: swap(mapping, other.mapping);
+                    std :: swap(mappingSize, other.mappingSize);
+                    std :: swap(dirty, other.dirty);
+
+                    return *this;
+                }
+
+                ~Fenwick () {
+                    if (mapping == nullptr)
+                        return;
+
+                    if (dirty && msync(mapping, mappingSize, MS_SYNC) == 0) { /// Saves the updates, as checkpoint() (without throwing).
+                        ((fenwickHeader *)mapping) -> clean = 1;
+                        msync(mapping, sizeof(fenwickHeader), MS_SYNC);
+                    }
+
+                    munmap(mapping, mappingSize);
+                }
+        };
+}
+
+#endif
@@ -0,0 +1,359 @@
+/// Adjacency providers, for graphs which don't fit in memory as adjacency lists (see dijkstra.h).
+
+/// A provider of a directed graph with costs of type T has:
+/// typedef T cost;
+/// size() -> the number of vertices (numbered from 0).
+/// forEach(u, f) -> calls f(v, c) for every edge u -> v with the cost c.
+/// prefetch(u) -> a hint that the edges of u will be needed soon (it may do nothing).
+
+/// Two providers are available:
+
+/// csrGraph < T > G(path) -> a graph saved in a file in CSR format (every vertex has its edges in a contiguous range), which is mapped
+/// in memory, so only the pages which are used are read from the disk (if the file is bigger than half of the memory, prefetch(u)
+/// starts reading the pages of u in the background). csrGraph < T > :: write(in, path) creates such a file from a list of edges
+/// sorted by their source vertex, reading it only once.
+/// callbackGraph < T, F > G(n, f) -> an implicit graph (e.g. a grid), where f(u, emit) calls emit(v, c) for every edge u -> v.
+
+/// spillArray < T > A(n, budget) is an array of n elements which lives in memory if it takes at most budget bytes, and in a
+/// memory-mapped temporary file otherwise.
+
+#ifndef ADS_GRAPH_H
+#define ADS_GRAPH_H
+
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <istream>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace ads {
+    template < typename T >
+        class spillArray {
+            private:
+                long long n;
+                T *data;
+                std :: vector < T > memory;
+                void *mapping;
+                size_t mappingSize;
+            public:
+                spillArray (long long _n, long long budget, T value) {
+                    /// Complexity: O(n).
+
+                    n = _n;
+                    mapping = nullptr;
+                    mappingSize = 0;
+
+                    if (n * (long long)sizeof(T) <= budget) {
+                        memory.assign(n, value);
+                        data = memory.data();
+
+                        return;
+                    }
+
+                    const char *dir = std :: getenv("TMPDIR");
+                    std :: string path = std :: string(dir != nullptr ? dir : "/tmp") + "/ads-spill-XXXXXX";
+
+                    int fd = mkstemp(&path[0]);
+
+                    if (fd == -1)
+                        throw std :: runtime_error("spillArray: cannot create a file in " + path);
+
+                    unlink(path.c_str()); /// The file is deleted when it is unmapped.
+
+                    mappingSize = std :: max((size_t)1, size_t(n) * sizeof(T));
+
+                    if (ftruncate(fd, mappingSize) == -1) {
+                        close(fd);
+                        throw std :: runtime_error("spillArray: cannot resize " + path);
+                    }
+
+                    mapping = mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+                    close(fd);
+
+                    if (mapping == MAP_FAILED) {
+                        mapping = nullptr;
+                        throw std :: runtime_error("spillArray: cannot map " + path);
+                    }
+
+                    data = (T *)mapping;
+
+                    for (long long i = 0; i < n; ++ i)
+                        data[i] = value;
+                }
+
+                spillArray (spillArray &&other) {
+                    n = other.n;
+                    data = other.data;
+                    memory = std :: move(other.memory);
+                    mapping = other.mapping;
+                    mappingSize = other.mappingSize;
+
+                    other.mapping = nullptr;
+                }
+
+                spillArray (const spillArray &other) = delete;
+                spillArray & operator = (const spillArray &other) = delete;
+
+                ~spillArray () {
+                    if (mapping != nullptr)
+                        munmap(mapping, mappingSize);
+                }
+
+                T & operator [] (long long i) {
+                    return data[i];
+                }
+
+                long long size() {
+                    return n;
+                }
+
+                bool spilled() {
+                    return (mapping != nullptr);
+                }
+        };
+
+    template < typename T >
+        struct csrEdge {
+            T cost;
+            int v;
+        };
+
+    struct csrHeader {
+        /// The first 64 bytes of a csrGraph file. Then come offsets[0 .. n] (the edges of u are edges[offsets[u] .. offsets[u + 1])),
+        /// then edges[0 .. m - 1].
+
+        char magic[8];
+        long long n, m;
+        int size, type; /// sizeof(csrEdge < T >) and whether T is unsigned (0), signed (1) or floating-point (2).
+        char padding[32];
+    };
+
+    template < typename T >
+        class csrGraph {
+            private:
+                long long n, m;
+                const long long *offsets;
+                const csrEdge < T > *edges;
+                void *mapping;
+                size_t mappingSize;
+                uintptr_t pageSize;
+                bool large; /// Whether the graph may not stay in the page cache (see prefetch).
+
+                static int type() {
+                    return (std :: is_floating_point < T > :: value ? 2 : std :: is_signed < T > :: value ? 1 : 0);
+                }
+            public:
+                typedef T cost;
+
+                static void write(std :: istream &in, const char *path) {
+                    /// Reads n and m, then m edges "u v c" sorted by u, and saves them in path.
+                    /// Both the edges and the offsets are written sequentially, so only O(1) memory is used.
+                    /// If the sizes or the edges aren't valid, or the file can't be written (e.g. the disk is full), removes the file and throws.
+                    /// Complexity: O(n + m).
+
+                    csrHeader h;
+
+                    memset(&h, 0, sizeof(h));
+                    memcpy(h.magic, "CSRGRPH", 8);
+                    h.size = sizeof(csrEdge < T >);
+                    h.type = type();
+
+                    FILE *offsetFile = std :: fopen(path, "wb");
+
+                    if (offsetFile == nullptr)
+                        throw std :: runtime_error(std :: string("csrGraph: cannot create ") + path);
+
+                    FILE *edgeFile = std :: fopen(path, "r+b"); /// A second position in the same file.
+
+                    if (edgeFile == nullptr) {
+                        std :: fclose(offsetFile);
+                        std :: remove(path);
+                        throw std :: runtime_error(std :: string("csrGraph: cannot create ") + path);
+                    }
+
+                    auto fail = [&](std :: string what) {
+                        /// Removes the partial file, so it can't be opened later.
+
+                        std :: fclose(offsetFile);
+                        std :: fclose(edgeFile);
+                        std :: remove(path);
+
+                        throw std :: runtime_error(std :: string("csrGraph: ") + what);
+                    };
+
+                    in >> h.n >> h.m;
+
+                    if (!in || h.n < 0 || h.m < 0)
+                        fail(std :: string("the sizes of the graph for ") + path + " aren't valid");
+
+                    csrHeader blank; /// The header is written last, so a file which wasn't written completely can't be opened.
+
+                    memset(&blank, 0, sizeof(blank));
+
+                    if (std :: fwrite(&blank, sizeof(blank), 1, offsetFile) != 1 || std :: fseek(edgeFile, sizeof(h) + (h.n + 1) * sizeof(long long), SEEK_SET) != 0)
+                        fail(std :: string("cannot write ") + path);
+
+                    long long next = 0; /// The first vertex whose offset isn't written yet.
+
+                    for (long long i = 0; i < h.m; ++ i) {
+                        long long u;
+                        csrEdge < T > e;
+
+                        memset(&e, 0, sizeof(e)); /// The padding is written too, so the same edges always give the same file.
+
+                        in >> u >> e.v >> e.cost;
+
+                        if (!in || u < 0 || u < next - 1 || u >= h.n || e.v < 0 || e.v >= h.n)
+                            fail(std :: string("the edges for ") + path + " aren't valid, or aren't sorted by source");
+
+                        for (; next <= u; ++ next)
+                            if (std :: fwrite(&i, sizeof(i), 1, offsetFile) != 1)
+                                fail(std :: string("cannot write ") + path);
+
+                        if (std :: fwrite(&e, sizeof(e), 1, edgeFile) != 1)
+                            fail(std :: string("cannot write ") + path);
+                    }
+
+                    for (; next <= h.n; ++ next)
+                        if (std :: fwrite(&h.m, sizeof(h.m), 1, offsetFile) != 1)
+                            fail(std :: string("cannot write ") + path);
+
+                    bool ok = (std :: fclose(edgeFile) == 0); /// The edges reach the file before the header.
+
+                    ok = (std :: fseek(offsetFile, 0, SEEK_SET) == 0 && std :: fwrite(&h, sizeof(h), 1, offsetFile) == 1 && ok);
+                    ok = (std :: fclose(offsetFile) == 0 && ok);
+
+                    if (!ok) {
+                        std :: remove(path);
+                        throw std :: runtime_error(std :: string("csrGraph: cannot write ") + path);
+                    }
+
+                    return;
+                }
+
+                csrGraph (const char *path, bool sequential = false) {
+                    /// Maps the graph saved in path. By default the kernel reads only the used pages, since dijkstra visits the vertices
+                    /// in an almost random order. If sequential is set, it also reads ahead the pages which follow the used ones
+                    /// (good if the vertices are visited in the order of their numbers, e.g. a scan, or a BFS-renumbered graph).
+                    /// Complexity: O(1).
+
+                    int fd = open(path, O_RDONLY);
+                    struct stat st;
+                    csrHeader h;
+
+                    if (fd == -1 || fstat(fd, &st) == -1 || st.st_size < (off_t)sizeof(h) || pread(fd, &h, sizeof(h), 0) != sizeof(h)) {
+                        if (fd != -1)
+                            close(fd);
+
+                        throw std :: runtime_error(std :: string("csrGraph: cannot read ") + path);
+                    }
+
+                    if (memcmp(h.magic, "CSRGRPH", 8) != 0 || h.size != sizeof(csrEdge < T >) || h.type != type() || h.n < 0 || h.m < 0 ||
+                        st.st_size != (off_t)(sizeof(h) + (h.n + 1) * sizeof(long long) + h.m * sizeof(csrEdge < T >))) {
+                        close(fd);
+                        throw std :: runtime_error(std :: string("csrGraph: ") + path + " doesn't hold a graph with this type of costs");
+                    }
+
+                    n = h.n;
+                    m = h.m;
+                    mappingSize = st.st_size;
+                    mapping = mmap(nullptr, mappingSize, PROT_READ, MAP_SHARED, fd, 0);
+                    close(fd);
+
+                    if (mapping == MAP_FAILED)
+                        throw std :: runtime_error(std :: string("csrGraph: cannot map ") + path);
+
+                    madvise(mapping, mappingSize, sequential ? MADV_SEQUENTIAL : MADV_RANDOM);
+
+                    offsets = (const long long *)((char *)mapping + sizeof(h));
+                    edges = (const csrEdge < T > *)(offsets + n + 1);
+                    pageSize = sysconf(_SC_PAGESIZE);
+                    large = (mappingSize / pageSize > (size_t)sysconf(_SC_PHYS_PAGES) / 2); /// More than half of the memory.
+
+                    madvise(mapping, sizeof(h) + (n + 1) * sizeof(long long), MADV_WILLNEED); /// The offsets are small (8 bytes per vertex), and every prefetch needs them.
+                }
+
+                csrGraph (const csrGraph &other) = delete;
+                csrGraph & operator = (const csrGraph &other) = delete;
+
+                ~csrGraph () {
+                    munmap(mapping, mappingSize);
+                }
+
+                int size() {
+                    return n;
+                }
+
+                long long edgeCount() {
+                    return m;
+                }
+
+                template < typename F >
+                    void forEach(int u, F f) {
+                        for (long long i = offsets[u], end = offsets[u + 1]; i < end; ++ i)
+                            f(edges[i].v, edges[i].cost);
+                    }
+
+                void prefetch(int u) {
+                    /// Brings the first edges of u in the cache. If the graph doesn't fit in the memory, also asks the kernel to start
+                    /// reading the pages of the edges of u from the disk, without waiting for them (madvise costs a system call,
+                    /// so it is skipped when the pages can stay cached). The offsets are read ahead when the graph is opened.
+
+                    const csrEdge < T > *first = edges + offsets[u], *last = edges + offsets[u + 1];
+
+                    if (large && first != last) {
+                        uintptr_t begin = (uintptr_t)first & ~(pageSize - 1); /// madvise needs a page-aligned address.
+
+                        madvise((void *)begin, (uintptr_t)last - begin, MADV_WILLNEED);
+                    }
+
+                    __builtin_prefetch(first);
+
+                    return;
+                }
+        };
+
+    template < typename T, typename F >
+        class callbackGraph {
+            private:
+                int n;
+                F f;
+            public:
+                typedef T cost;
+
+                callbackGraph (int _n, F _f) : n(_n), f(_f) {}
+
+                int size() {
+                    return n;
+                }
+
+                template < typename G >
+                    void forEach(int u, G emit) {
+                        f(u, emit);
+                    }
+
+                void prefetch(int) {
+                    return;
+                }
+        };
+
+    template < typename T, typename F >
+        callbackGraph < T, F > makeCallbackGraph(int n, F f) {
+            /// Lets the type of f be deduced: auto G = makeCallbackGraph < long long > (n, [&](int u, auto emit) { ... }).
+
+            return callbackGraph < T, F > (n, f);
+        }
+}
+
+#endif
@@ -0,0 +1,482 @@
+/// An asynchronous service which answers dsu and Fenwick requests over a local (Unix) socket, written with C++20 coroutines.
+
+/// Every connection is served by a coroutine. It reads all the requests available on its socket and hands them to the batcher
+/// (queryService), then sleeps until they are answered. After every round of socket events, the batcher answers all the
+/// requests it gathered (a micro-batch, of at most maxBatch requests):
+
+/// [1]: The batch is split in runs of queries, separated by updates (so every update still sees the same requests before it).
+/// [2]: The queries of a run are sorted by position / vertex, so the neighbouring requests touch neighbouring memory.
+/// [3]: While answering a request, the memory of the request which comes PREFETCH positions later is prefetched.
+
+/// The time between reading a request and answering it is recorded in a latency histogram (p50, p99, ...).
+
+/// The requests / responses have a fixed size (see request and response), and a connection gets its responses in the order of its requests.
+
+/// '?' x y -> dsu :: query(x, y)             '+' x y -> dsu :: add(x, y)
+/// 's' x y -> Fenwick :: Query(x, y)         'u' x y val -> Fenwick :: Update(x, y, val)
+/// 'p' x -> the x-th percentile of the latency, in nanoseconds
+
+/// How to use: see query-service.cpp (a server and a load generator).
+
+/// VERY IMPORTANT! Needs C++20 (coroutines) and Linux (epoll).
+
+#ifndef ADS_QUERY_SERVICE_H
+#define ADS_QUERY_SERVICE_H
+
+#include <chrono>
+#include <vector>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <utility>
+#include <algorithm>
+#include <coroutine>
+#include <exception>
+#include <unordered_map>
+
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+
+#include "dsu.h"
+#include "fenwick.h"
+
+namespace ads {
+    struct request {
+        unsigned id; /// Copied in the response.
+        int op; /// Can take the following symbols: '?', '+', 's', 'u', 'p'.
+        int x, y;
+        long long val;
+    };
+
+    struct response {
+        unsigned id;
+        int ok; /// 0 if the request isn't valid.
+        long long value;
+    };
+
+    inline long long now() {
+        /// Nanoseconds since an arbitrary moment.
+
+        return std :: chrono :: duration_cast < std :: chrono :: nanoseconds > (std :: chrono :: steady_clock :: now().time_since_epoch()).count();
+    }
+
+    class latencyHistogram {
+        /// Every power of two is divided in 16 buckets, so the percentiles are off by at most 1/16 = 6.25%.
+
+        private:
+            static const int SUB = 16;
+            std :: vector < long long > bucket;
+            long long cnt;
+        public:
+            latencyHistogram () : bucket(64 * SUB, 0), cnt(0) {}
+
+            static int index(long long v) {
+                if (v < SUB)
+                    return std :: max(v, 0LL);
+
+                int k = 63 - __builtin_clzll(v); /// 2^k <= v < 2^(k + 1)
+
+                return (k - 3) * SUB + ((v >> (k - 4)) & (SUB - 1));
+            }
+
+            static long long lowest(int i) {
+                /// The smallest value of bucket i.
+
+                if (i < SUB)
+                    return i;
+
+                int k = i / SUB + 3;
+
+                return (1LL << k) + ((long long)(i % SUB) << (k - 4));
+            }
+
+            void record(long long v) {
+                ++ bucket[index(v)];
+                ++ cnt;
+
+                return;
+            }
+
+            void merge(const latencyHistogram &other) {
+                for (int i = 0; i < bucket.size(); ++ i)
+                    bucket[i] += other.bucket[i];
+
+                cnt += other.cnt;
+
+                return;
+            }
+
+            long long percentile(double p) {
+                /// The smallest value v such that at least p% of the values are <= v (rounded down to its bucket).
+
+                long long need = std :: max(1LL, (long long)(p / 100 * cnt + 0.5)), seen = 0;
+
+                for (int i = 0; i < bucket.size(); ++ i) {
+                    seen += bucket[i];
+
+                    if (seen >= need)
+                        return lowest(i);
+                }
+
+                return 0;
+            }
+
+            long long count() {
+                return cnt;
+            }
+    };
+
+    struct task {
+        /// A coroutine which starts right away, and frees itself when it ends. Nobody waits for it.
+
+        struct promise_type {
+            task get_return_object() {
+                return {};
+            }
+
+            std :: suspend_never initial_suspend() {
+                return {};
+            }
+
+            std :: suspend_never final_suspend() noexcept {
+                return {};
+            }
+
+            void return_void() {}
+
+            void unhandled_exception() {
+                std :: terminate();
+            }
+        };
+    };
+
+    class eventLoop {
+        /// Resumes the coroutines waiting for their sockets, with epoll.
+
+        private:
+            int ep;
+            std :: unordered_map < int, std :: coroutine_handle <> > waiting; /// A socket -> the coroutine waiting for it.
+            std :: unordered_map < int, bool > registered;
+
+            struct io {
+                eventLoop &loop;
+                int fd;
+                unsigned events;
+
+                bool await_ready() {
+                    return false;
+                }
+
+                void await_suspend(std :: coroutine_handle <> h) {
+                    epoll_event e;
+
+                    e.events = events | EPOLLONESHOT;
+                    e.data.fd = fd;
+
+                    epoll_ctl(loop.ep, loop.registered[fd] ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, fd, &e);
+
+                    loop.registered[fd] = true;
+                    loop.waiting[fd] = h;
+                }
+
+                void await_resume() {}
+            };
+        public:
+            eventLoop () {
+                ep = epoll_create1(0);
+            }
+
+            ~eventLoop () {
+                close(ep);
+            }
+
+            io readable(int fd) {
+                return {*this, fd, EPOLLIN};
+            }
+
+            io writable(int fd) {
+                return {*this, fd, EPOLLOUT};
+            }
+
+            void forget(int fd) {
+                /// Must be called before closing a socket.
+
+                epoll_ctl(ep, EPOLL_CTL_DEL, fd, nullptr);
+                registered.erase(fd);
+                waiting.erase(fd);
+
+                return;
+            }
+
+            template < typename F >
+                void run(volatile std :: sig_atomic_t &stop, F afterEvents) {
+                    /// Resumes the coroutines whose sockets are ready, then calls afterEvents(), until stop is set (e.g. by a signal).
+                    /// If afterEvents() returns true (it has more work), the next round doesn't wait for new events.
+
+                    epoll_event e[256];
+                    bool busy = false;
+
+                    while (!stop) {
+                        int k = epoll_wait(ep, e, 256, busy ? 0 : -1);
+
+                        for (int i = 0; i < k; ++ i) {
+                            std :: unordered_map < int, std :: coroutine_handle <> > :: iterator it = waiting.find(e[i].data.fd);
+
+                            if (it != waiting.end()) {
+                                std :: coroutine_handle <> h = it -> second;
+
+                                waiting.erase(it);
+                                h.resume();
+                            }
+                        }
+
+                        busy = afterEvents();
+                    }
+
+                    return;
+                }
+    };
+
+    class queryService {
+        private:
+            static const int PREFETCH = 8; /// How many requests ahead the memory is prefetched.
+
+            struct chunk {
+                /// The requests read at once by a connection.
+
+                const request *req;
+                response *res;
+                int k;
+                long long received;
+                std :: coroutine_handle <> h;
+            };
+
+            struct submission {
+                queryService &S;
+                chunk c;
+
+                bool await_ready() {
+                    return (c.k == 0);
+                }
+
+                void await_suspend(std :: coroutine_handle <> h) {
+                    c.h = h;
+                    S.waiting.push_back(c);
+                }
+
+                void await_resume() {}
+            };
+
+            dsu <> &D;
+            Fenwick < long long > &F;
+            int n, maxBatch;
+            std :: vector < chunk > waiting;
+            std :: vector < std :: pair < const request *, response * > > run; /// The queries between two updates.
+
+            static bool isUpdate(int op) {
+                return (op == '+' || op == 'u');
+            }
+
+            static int key(const request &r) {
+                return std :: min(r.x, r.y);
+            }
+
+            void prefetch(const request &r) {
+                if (r.x < 0 || r.y < 0 || r.x > n || r.y > n)
+                    return;
+
+                if (r.op == '?' || r.op == '+') {
+                    D.prefetch(r.x);
+                    D.prefetch(r.y);
+                }
+                else if ((r.op == 's' || r.op == 'u') && r.x > 0 && r.y > 0)
+                    F.prefetch(r.x, r.y);
+
+                return;
+            }
+
+            void answer(const request &r, response &res) {
+                res.id = r.id;
+                res.ok = 1;
+                res.value = 0;
+
+                if (r.op == 'p')
+                    res.value = latency.percentile(r.x);
+                else if (r.x < 0 || r.y < 0 || r.x > n || r.y > n || ((r.op == 's' || r.op == 'u') && (r.x == 0 || r.y == 0)))
+                    res.ok = 0;
+                else if (r.op == '?')
+                    res.value = D.query(r.x, r.y);
+                else if (r.op == '+')
+                    res.value = D.add(r.x, r.y);
+                else if (r.op == 's')
+                    res.value = F.Query(r.x, r.y);
+                else if (r.op == 'u')
+                    F.Update(r.x, r.y, r.val);
+                else
+                    res.ok = 0;
+
+                return;
+            }
+
+            void answerRun() {
+                /// Answers the queries of run, sorted by position / vertex, prefetching PREFETCH requests ahead.
+
+                std :: sort(run.begin(), run.end(), [](const std :: pair < const request *, response * > &a, const std :: pair < const request *, response * > &b) {
+                    return key(*a.first) < key(*b.first);
+                });
+
+                for (int i = 0; i < run.size(); ++ i) {
+                    if (i + PREFETCH < run.size())
+                        prefetch(*run[i + PREFETCH].first);
+
+                    answer(*run[i].first, *run[i].second);
+                }
+
+                run.clear();
+
+                return;
+            }
+
+            void answerBatch(std :: vector < chunk > &batch, int l, int r) {
+                /// Answers the requests of the chunks batch[l .. r - 1], then wakes up their connections.
+
+                for (int i = l; i < r; ++ i)
+                    for (int j = 0; j < batch[i].k; ++ j) {
+                        const request &q = batch[i].req[j];
+
+                        if (isUpdate(q.op)) {
+                            answerRun();
+                            answer(q, batch[i].res[j]);
+                        }
+                        else
+                            run.push_back({&q, &batch[i].res[j]});
+                    }
+
+                answerRun();
+
+                long long t = now();
+                int size = 0;
+
+                for (int i = l; i < r; ++ i) {
+                    for (int j = 0; j < batch[i].k; ++ j)
+                        latency.record(t - batch[i].received);
+
+                    size += batch[i].k;
+                }
+
+                batchSizes.record(size);
+
+                return;
+            }
+        public:
+            latencyHistogram latency; /// The time between reading a request and answering it, in nanoseconds.
+            latencyHistogram batchSizes; /// The number of requests in every micro-batch.
+
+            queryService (dsu <> &_D, Fenwick < long long > &_F, int _n, int _maxBatch = 4096) : D(_D), F(_F), n(_n), maxBatch(_maxBatch) {}
+
+            submission submit(const request *req, response *res, int k, long long received) {
+                /// co_await S.submit(req, res, k, received) -> fills res[0 .. k - 1] with the answers of req[0 .. k - 1].
+
+                return {*this, {req, res, k, received, nullptr}};
+            }
+
+            bool flush() {
+                /// Answers all the requests gathered since the last flush, in micro-batches of at most maxBatch requests
+                /// (a chunk is never split), and resumes their connections. Returns true if the resumed connections
+                /// already submitted new requests (they had more requests to read), for the next flush.
+
+                std :: vector < chunk > batch;
+
+                batch.swap(waiting); /// The resumed connections may submit new requests, for the next flush.
+
+                for (int l = 0, r = 0; l < batch.size(); l = r) {
+                    int size = 0;
+
+                    for (r = l; r < batch.size() && (r == l || size + batch[r].k <= maxBatch); ++ r)
+                        size += batch[r].k;
+
+                    answerBatch(batch, l, r);
+                }
+
+                for (int i = 0; i < batch.size(); ++ i)
+                    batch[i].h.resume();
+
+                return !waiting.empty();
+            }
+    };
+
+    inline task session(eventLoop &loop, queryService &S, int fd) {
+        /// Serves a connection: reads its requests, waits for the answers of the batcher, and writes them back.
+
+        const int CAPACITY = 4096; /// The maximum number of requests read at once.
+
+        std :: vector < request > req(CAPACITY);
+        std :: vector < response > res(CAPACITY);
+
+        size_t have = 0; /// The number of bytes in req.
+        bool open = true;
+
+        while (open) {
+            ssize_t r = read(fd, (char *)req.data() + have, CAPACITY * sizeof(request) - have);
+
+            if (r == 0 || (r < 0 && errno != EAGAIN && errno != EINTR))
+                break;
+
+            if (r < 0) {
+                co_await loop.readable(fd);
+                continue;
+            }
+
+            have += r;
+
+            int k = have / sizeof(request);
+
+            if (k == 0)
+                continue;
+
+            co_await S.submit(req.data(), res.data(), k, now());
+
+            have -= k * sizeof(request);
+            memmove(req.data(), req.data() + k, have); /// Keeps the incomplete request.
+
+            const char *p = (const char *)res.data();
+            size_t left = k * sizeof(response);
+
+            while (left > 0) {
+                ssize_t w = write(fd, p, left);
+
+                if (w > 0) {
+                    p += w;
+                    left -= w;
+                }
+                else if (w < 0 && errno == EAGAIN)
+                    co_await loop.writable(fd);
+                else if (!(w < 0 && errno == EINTR)) {
+                    open = false;
+                    break;
+                }
+            }
+        }
+
+        loop.forget(fd);
+        close(fd);
+    }
+
+    inline task acceptor(eventLoop &loop, queryService &S, int listener) {
+        /// Accepts the connections, and starts a session for each of them. listener must be non-blocking.
+
+        while (true) {
+            int fd = accept4(listener, nullptr, nullptr, SOCK_NONBLOCK);
+
+            if (fd >= 0)
+                session(loop, S, fd);
+            else if (errno == EAGAIN)
+                co_await loop.readable(listener);
+            else if (errno != EINTR)
+                co_return;
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,228 @@
+/// This data structure applies the following updates / queries online on a vector, in O(log n) time:
+
+/// [1] : Adds a value C to all elements situated on a contiguous subarray [x, y].
+/// [2] : Queries the sum / minimum / maximum (or any other monoid, see below) of all elements on a contiguous subarray [x, y].
+
+/// How to use:
+
+/// Declare ads :: SegmentTree < T, ads :: minMonoid < T > > A(v), then call A.Update(x, y, C) and A.Query(x, y) (see segment-tree.cpp).
+
+/// A monoid is a class with three static functions:
+/// identity() -> the neutral element of combine (e.g. 0 for sums, +INF for minimums).
+/// combine(a, b) -> the answer for two neighbouring subarrays with the answers a and b.
+/// apply(a, C, len) -> the answer for a subarray of len elements with the answer a, after C is added to all its elements.
+
+/// The tree is stored in an implicit (BFS / Eytzinger) layout: the root is node 1, the children of node k are 2k and 2k + 1,
+/// and the leaves are the last size nodes. An inner node keeps its answer and its additions side by side (one cache line), a leaf
+/// only its answer (in a separate array). Both the updates and the queries walk bottom-up, without recursion. The additions are
+/// never pushed down: a node keeps the additions which covered it, and the queries apply them while walking up.
+
+/// The additions must distribute over combine and add up:
+/// apply(combine(a, b), C, la + lb) = combine(apply(a, C, la), apply(b, C, lb)) and apply(apply(a, C, len), D, len) = apply(a, C + D, len).
+/// In particular, adding 0 must change nothing: the updates and the queries add 0 instead of branching on the borders of [x, y].
+
+/// VERY IMPORTANT! Only works if you are working on 1-indexed vector (like Fenwick).
+
+#ifndef ADS_SEGMENT_TREE_H
+#define ADS_SEGMENT_TREE_H
+
+#include <limits>
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+namespace ads {
+    template < typename T >
+        struct sumMonoid {
+            static T identity() {
+                return 0;
+            }
+
+            static T combine(T a, T b) {
+                return a + b;
+            }
+
+            static T apply(T a, T C, int len) {
+                return a + C * len;
+            }
+        };
+
+    template < typename T >
+        struct minMonoid {
+            static T identity() {
+                return std :: numeric_limits < T > :: max();
+            }
+
+            static T combine(T a, T b) {
+                return (a < b ? a : b);
+            }
+
+            static T apply(T a, T C, int) {
+                return a + C;
+            }
+        };
+
+    template < typename T >
+        struct maxMonoid {
+            static T identity() {
+                return std :: numeric_limits < T > :: lowest();
+            }
+
+            static T combine(T a, T b) {
+                return (a < b ? b : a);
+            }
+
+            static T apply(T a, T C, int) {
+                return a + C;
+            }
+        };
+
+    template < typename T, typename Monoid = sumMonoid < T > >
+        class SegmentTree {
+            private:
+                int n, LOG, size; /// size = the smallest power of 2 >= n, LOG = log2(size).
+                struct node {
+                    T d; /// The answer for the subarray of the node, without the additions of its ancestors.
+                    T lazy; /// The sum of the additions that covered the whole subarray of the node.
+                };
+
+                std :: vector < node > t; /// The nodes 0 .. size - 1 (node 0 holds identity()), so d and lazy share a cache line.
+                std :: vector < T > leaf; /// leaf[k - size + 1] = the answer of leaf k, without a lazy field (leaf[0] holds identity()).
+
+                void pull(int k, int len) {
+                    /// Recomputes node k, whose subarray has len elements.
+
+                    t[k].d = Monoid :: apply(Monoid :: combine(t[2 * k].d, t[2 * k + 1].d), t[k].lazy, len);
+
+                    return;
+                }
+
+                void pullLeaves(int k) {
+                    /// Recomputes node k, whose children are leaves.
+
+                    t[k].d = Monoid :: apply(Monoid :: combine(leaf[2 * k - size + 1], leaf[2 * k - size + 2]), t[k].lazy, 2);
+
+                    return;
+                }
+            public:
+                void Update(int x, int y, T val) {
+                    /// Adds val to the O(log n) nodes which cover [x, y], then recomputes their ancestors bottom-up.
+                    /// Complexity: O(log n).
+
+                    if (x > y)
+                        std :: swap(x, y);
+
+                    int l = x - 1 + size, r = y + size;
+                    T A = val * (l & 1), B = val * (r & 1); /// Adding 0 changes nothing, so there are no branches on the random borders.
+
+                    leaf[l - size + 1] = Monoid :: apply(leaf[l - size + 1], A, 1);
+                    leaf[r - size] = Monoid :: apply(leaf[r - size], B, 1); /// If r - 1 = l, at most one of A and B is val.
+
+                    for (int a = (l + 1) >> 1, b = r >> 1, len = 2; a < b; a >>= 1, b >>= 1, len <<= 1) {
+                        A = val * (a & 1);
+                        B = val * (b & 1);
+
+                        t[a].d = Monoid :: apply(t[a].d, A, len);
+                        t[a].lazy += A;
+                        t[b - 1].d = Monoid :: apply(t[b - 1].d, B, len);
+                        t[b - 1].lazy += B;
+
+                        a += (a & 1);
+                        b -= (b & 1);
+                    }
+
+                    if (LOG == 0)
+                        return;
+
+                    pullLeaves(l >> 1);
+
+                    if ((l >> 1) != ((r - 1) >> 1))
+                        pullLeaves((r - 1) >> 1);
+
+                    int i = 2;
+
+                    for (; (l >> i) != ((r - 1) >> i); ++ i) { /// The two paths join at the latest in the root (i = LOG), then only one is pulled.
+                        pull(l >> i, 1 << i);
+                        pull((r - 1) >> i, 1 << i);
+                    }
+
+                    for (; i <= LOG; ++ i)
+                        pull(l >> i, 1 << i);
+
+                    return;
+                }
+
+                T Query(int x, int y) {
+                    /// Combines the O(log n) nodes which cover [x, y] bottom-up. The additions of their ancestors are applied while walking up:
+                    /// every ancestor of the nodes taken so far on the left (right) side is an ancestor of the last node taken on that side.
+                    /// Complexity: O(log n).
+
+                    if (x > y)
+                        std :: swap(x, y);
+
+                    int l = x - 1 + size, r = y + size;
+                    int maskL = -(l & 1), maskR = -(r & 1); /// All bits set if the node is taken. Branch-free, since the borders are random.
+
+                    T left = leaf[(l - size + 1) & maskL], right = leaf[(r - size) & maskR]; /// The leaves, with no additions of their own.
+
+                    int lastL = l & maskL, lastR = (r - 1) & maskR; /// Node 0 is not in the tree (identity(), with no additions), so it stands for "no node taken yet".
+                    int lenL = 1 & maskL, lenR = 1 & maskR;
+
+                    l = (l - maskL) >> 1;
+                    r = (r + maskR) >> 1;
+
+                    for (int len = 2; l < r; l >>= 1, r >>= 1, len <<= 1) {
+                        lastL >>= 1;
+                        lastR >>= 1;
+
+                        left = Monoid :: apply(left, t[lastL].lazy, lenL);
+                        right = Monoid :: apply(right, t[lastR].lazy, lenR);
+
+                        maskL = -(l & 1);
+                        maskR = -(r & 1);
+
+                        left = Monoid :: combine(left, t[l & maskL].d); /// Node 0 holds identity().
+                        right = Monoid :: combine(t[(r - 1) & maskR].d, right);
+
+                        lastL ^= ((lastL ^ l) & maskL);
+                        lastR ^= ((lastR ^ (r - 1)) & maskR);
+                        lenL += (len & maskL);
+                        lenR += (len & maskR);
+
+                        l -= maskL;
+                        r += maskR;
+                    }
+
+                    for (lastL >>= 1; lastL > 0; lastL >>= 1)
+                        left = Monoid :: apply(left, t[lastL].lazy, lenL);
+
+                    for (lastR >>= 1; lastR > 0; lastR >>= 1)
+                        right = Monoid :: apply(right, t[lastR].lazy, lenR);
+
+                    return Monoid :: combine(left, right);
+                }
+
+                SegmentTree (std :: vector < T > v) {
+                    /// Complexity: O(n).
+
+                    n = v.size();
+
+                    for (LOG = 0, size = 1; size < n; ++ LOG)
+                        size <<= 1;
+
+                    t.assign(size, {Monoid :: identity(), 0});
+                    leaf.assign(size + 1, Monoid :: identity());
+
+                    for (int i = 0; i < n; ++ i)
+                        leaf[i + 1] = v[i];
+
+                    for (int k = size - 1; k >= size / 2 && k >= 1; -- k)
+                        pullLeaves(k);
+
+                    for (int k = size / 2 - 1; k >= 1; -- k)
+                        pull(k, size >> (31 - __builtin_clz(k)));
+                }
+        };
+}
+
+#endif
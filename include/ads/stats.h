@@ -0,0 +1,124 @@
+/// Statistics policies for the hot paths of dsu, dijkstra, solver and the Hamiltonian path heuristic.
+
+/// The data structures take the policy as a template parameter (noStats by default):
+
+/// noStats -> records nothing. Every call is empty, and the code recording the statistics is removed at compile time (enabled = false).
+/// stats -> records named counters and histograms (with power-of-two buckets), and prints them with dump().
+
+/// How to use:
+
+/// ads :: dsu < ads :: stats > T(n);
+/// ...
+/// T.stats.dump(std :: cerr);
+
+#ifndef ADS_STATS_H
+#define ADS_STATS_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include <ostream>
+#include <algorithm>
+
+namespace ads {
+    class noStats {
+        public:
+            static const bool enabled = false;
+
+            void count(const char *, long long = 1) {}
+            void record(const char *, long long) {}
+            void merge(const noStats &) {}
+            void dump(std :: ostream &) {}
+    };
+
+    class stats {
+        private:
+            struct histogram {
+                long long cnt = 0, sum = 0, Max = 0;
+                std :: vector < long long > bucket; /// bucket[i] = how many values are in [2^(i - 1), 2^i), bucket[0] = how many values are 0.
+            };
+
+            std :: map < std :: string, long long > counters;
+            std :: map < std :: string, histogram > histograms;
+        public:
+            static const bool enabled = true;
+
+            void count(const char *name, long long value = 1) {
+                /// Adds value to a counter.
+                /// Complexity: O(log (the number of names)).
+
+                counters[name] += value;
+
+                return;
+            }
+
+            void record(const char *name, long long value) {
+                /// Adds a (non-negative) value to a histogram.
+                /// Complexity: O(log (the number of names)).
+
+                histogram &h = histograms[name];
+                int i = 0;
+
+                while ((1LL << i) <= value)
+                    ++ i;
+
+                if (h.bucket.size() <= i)
+                    h.bucket.resize(i + 1, 0);
+
+                h.bucket[i] ++;
+                h.cnt ++;
+                h.sum += value;
+                h.Max = std :: max(h.Max, value);
+
+                return;
+            }
+
+            void merge(const stats &other) {
+                /// Adds the statistics of other to these ones.
+
+                for (std :: map < std :: string, long long > :: const_iterator it = other.counters.begin(); it != other.counters.end(); ++ it)
+                    counters[it -> first] += it -> second;
+
+                for (std :: map < std :: string, histogram > :: const_iterator it = other.histograms.begin(); it != other.histograms.end(); ++ it) {
+                    histogram &h = histograms[it -> first];
+
+                    if (h.bucket.size() < (it -> second).bucket.size())
+                        h.bucket.resize((it -> second).bucket.size(), 0);
+
+                    for (int i = 0; i < (it -> second).bucket.size(); ++ i)
+                        h.bucket[i] += (it -> second).bucket[i];
+
+                    h.cnt += (it -> second).cnt;
+                    h.sum += (it -> second).sum;
+                    h.Max = std :: max(h.Max, (it -> second).Max);
+                }
+
+                return;
+            }
+
+            void dump(std :: ostream &out) {
+                /// Prints every counter on a line, then every histogram, as: name: count, mean, max, and the non-empty buckets.
+
+                for (std :: map < std :: string, long long > :: iterator it = counters.begin(); it != counters.end(); ++ it)
+                    out << it -> first << ": " << it -> second << "\n";
+
+                for (std :: map < std :: string, histogram > :: iterator it = histograms.begin(); it != histograms.end(); ++ it) {
+                    histogram &h = it -> second;
+
+                    out << it -> first << ": count = " << h.cnt << ", mean = " << (h.cnt ? double(h.sum) / h.cnt : 0) << ", max = " << h.Max << "\n";
+
+                    for (int i = 0; i < h.bucket.size(); ++ i)
+                        if (h.bucket[i] > 0) {
+                            if (i == 0)
+                                out << "    0: " << h.bucket[i] << "\n";
+                            else
+                                out << "    [" << (1LL << (i - 1)) << ", " << (1LL << i) << "): " << h.bucket[i] << "\n";
+                        }
+                }
+
+                return;
+            }
+    };
+}
+
+#endif
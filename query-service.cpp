@@ -0,0 +1,259 @@
+/// Example driver for the query service (see include/ads/query-service.h): a server, and a load generator which measures it.
+
+/// ./query-service server <socket> <n> -> serves a dsu with the vertices 0 .. n and a Fenwick tree with the positions 1 .. n
+/// (all zeros at first) on the Unix socket <socket>, until SIGINT / SIGTERM, then prints its latency percentiles.
+
+/// ./query-service client <socket> <connections> <requests> <window> -> opens <connections> connections (one thread each),
+/// and sends <requests> random requests on each of them, keeping <window> requests in flight. The requests are 70% '?',
+/// 10% '+', 15% 's' and 5% 'u'. Prints the throughput, the latency percentiles seen by the clients and by the server.
+/// With a single connection, every answer is also checked against a local dsu and Fenwick tree (so the server must be fresh).
+
+#include <bits/stdc++.h>
+
+#include <poll.h>
+#include <signal.h>
+#include <sys/un.h>
+
+#include "include/ads/query-service.h"
+
+using ads :: dsu;
+using ads :: Fenwick;
+using ads :: request;
+using ads :: response;
+
+volatile std :: sig_atomic_t stop = 0; /// Set by the signal handler, so it must be a sig_atomic_t.
+
+void onSignal(int) {
+    stop = 1;
+
+    return;
+}
+
+sockaddr_un address(const char *path) {
+    sockaddr_un a;
+
+    memset(&a, 0, sizeof(a));
+    a.sun_family = AF_UNIX;
+    strncpy(a.sun_path, path, sizeof(a.sun_path) - 1);
+
+    return a;
+}
+
+bool exchange(int fd, const void *out, size_t outLen, void *in, size_t inLen) {
+    /// Sends out and receives in at the same time, so a window bigger than the socket buffers doesn't block both sides
+    /// (the server stops reading while it can't write its answers).
+
+    const char *p = (const char *)out;
+    char *q = (char *)in;
+
+    while (inLen > 0) {
+        pollfd e = {fd, short(POLLIN | (outLen > 0 ? POLLOUT : 0)), 0};
+
+        if (poll(&e, 1, -1) == -1) {
+            if (errno == EINTR)
+                continue;
+
+            return false;
+        }
+
+        if (outLen > 0 && (e.revents & POLLOUT)) {
+            ssize_t w = send(fd, p, outLen, MSG_DONTWAIT);
+
+            if (w < 0 && errno != EAGAIN && errno != EINTR)
+                return false;
+
+            if (w > 0) {
+                p += w;
+                outLen -= w;
+            }
+        }
+
+        if (e.revents & (POLLIN | POLLHUP | POLLERR)) {
+            ssize_t r = recv(fd, q, inLen, MSG_DONTWAIT);
+
+            if (r == 0 || (r < 0 && errno != EAGAIN && errno != EINTR))
+                return false;
+
+            if (r > 0) {
+                q += r;
+                inLen -= r;
+            }
+        }
+    }
+
+    return (outLen == 0);
+}
+
+int server(const char *path, int n) {
+    dsu D(n + 1);
+    Fenwick < long long > F(std :: vector < long long > (n, 0));
+    ads :: queryService S(D, F, n);
+    ads :: eventLoop loop;
+
+    int listener = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0);
+    sockaddr_un a = address(path);
+
+    unlink(path);
+
+    if (listener == -1 || bind(listener, (sockaddr *)&a, sizeof(a)) == -1 || listen(listener, 128) == -1) {
+        std :: cerr << "cannot listen on " << path << ": " << strerror(errno) << "\n";
+        return 1;
+    }
+
+    struct sigaction sa;
+
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = onSignal;
+    sigaction(SIGINT, &sa, nullptr);
+    sigaction(SIGTERM, &sa, nullptr);
+    signal(SIGPIPE, SIG_IGN); /// A client which disconnects early only ends its session.
+
+    ads :: acceptor(loop, S, listener);
+    loop.run(stop, [&]() {
+        return S.flush();
+    });
+
+    std :: cerr << "requests: " << S.latency.count() << ", batches: " << S.batchSizes.count() << "\n";
+    std :: cerr << "batch size p50: " << S.batchSizes.percentile(50) << ", p99: " << S.batchSizes.percentile(99) << "\n";
+    std :: cerr << "latency p50: " << S.latency.percentile(50) << " ns, p99: " << S.latency.percentile(99) << " ns\n";
+
+    close(listener);
+    unlink(path);
+
+    return 0;
+}
+
+int connectTo(const char *path) {
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un a = address(path);
+
+    if (fd == -1 || connect(fd, (sockaddr *)&a, sizeof(a)) == -1) {
+        std :: cerr << "cannot connect to " << path << ": " << strerror(errno) << "\n";
+        exit(1);
+    }
+
+    return fd;
+}
+
+int client(const char *path, int connections, int requests, int window) {
+    int n = 1000000; /// Only the positions 1 .. n are used, the server must have at least n.
+
+    std :: vector < ads :: latencyHistogram > latency(connections);
+    std :: atomic < long long > mismatches(0);
+    std :: vector < std :: thread > pool;
+
+    long long start = ads :: now();
+
+    for (int c = 0; c < connections; ++ c)
+        pool.emplace_back([&, c]() {
+            int fd = connectTo(path);
+            std :: mt19937 gen(c + 1);
+            std :: vector < request > req(window);
+            std :: vector < response > res(window);
+
+            std :: unique_ptr < dsu <> > D; /// The local copies, to check the answers.
+            std :: unique_ptr < Fenwick < long long > > F;
+
+            if (connections == 1) {
+                D.reset(new dsu <> (n + 1));
+                F.reset(new Fenwick < long long > (std :: vector < long long > (n, 0)));
+            }
+
+            for (int done = 0; done < requests; done += window) {
+                int k = std :: min(window, requests - done);
+
+                for (int i = 0; i < k; ++ i) {
+                    int p = gen() % 100;
+
+                    req[i].id = done + i;
+                    req[i].op = (p < 70 ? '?' : p < 80 ? '+' : p < 95 ? 's' : 'u');
+                    req[i].x = gen() % n + 1;
+                    req[i].y = gen() % n + 1;
+                    req[i].val = (int)(gen() % 2001) - 1000;
+                }
+
+                long long sent = ads :: now();
+
+                if (!exchange(fd, req.data(), k * sizeof(request), res.data(), k * sizeof(response))) {
+                    std :: cerr << "the server closed the connection\n";
+                    exit(1);
+                }
+
+                long long received = ads :: now();
+
+                for (int i = 0; i < k; ++ i) {
+                    latency[c].record(received - sent);
+
+                    if (D == nullptr)
+                        continue;
+
+                    long long expected = 0;
+
+                    if (req[i].op == '?')
+                        expected = D -> query(req[i].x, req[i].y);
+                    else if (req[i].op == '+')
+                        expected = D -> add(req[i].x, req[i].y);
+                    else if (req[i].op == 's')
+                        expected = F -> Query(req[i].x, req[i].y);
+                    else
+                        F -> Update(req[i].x, req[i].y, req[i].val);
+
+                    if (res[i].id != req[i].id || !res[i].ok || res[i].value != expected)
+                        ++ mismatches;
+                }
+            }
+
+            close(fd);
+        });
+
+    for (int i = 0; i < pool.size(); ++ i)
+        pool[i].join();
+
+    double seconds = (ads :: now() - start) / 1e9;
+
+    for (int c = 1; c < connections; ++ c)
+        latency[0].merge(latency[c]);
+
+    std :: cout << "throughput: " << (long long)(latency[0].count() / seconds) << " requests/s\n";
+    std :: cout << "client latency p50: " << latency[0].percentile(50) << " ns, p99: " << latency[0].percentile(99) << " ns\n";
+
+    int fd = connectTo(path);
+    request req[2] = {{0, 'p', 50, 0, 0}, {1, 'p', 99, 0, 0}};
+    response res[2];
+
+    if (exchange(fd, req, sizeof(req), res, sizeof(res)))
+        std :: cout << "server latency p50: " << res[0].value << " ns, p99: " << res[1].value << " ns\n";
+
+    close(fd);
+
+    if (connections == 1)
+        std :: cout << "mismatches: " << mismatches << "\n";
+
+    return (mismatches > 0);
+}
+
+int main(int argc, char *argv[]) {
+    if (argc == 4 && std :: string(argv[1]) == "server")
+        return server(argv[2], atoi(argv[3]));
+
+    if (argc == 6 && std :: string(argv[1]) == "client")
+        return client(argv[2], atoi(argv[3]), atoi(argv[4]), std :: max(1, atoi(argv[5])));
+
+    std :: cerr << "usage: " << argv[0] << " server <socket> <n>\n";
+    std :: cerr << "       " << argv[0] << " client <socket> <connections> <requests> <window>\n";
+
+    return 1;
+}
+
+/**
+Example:
+
+./query-service server /tmp/ads.sock 1000000 &
+./query-service client /tmp/ads.sock 1 1000000 64
+
+Output (client):
+throughput: ... requests/s
+client latency p50: ... ns, p99: ... ns
+server latency p50: ... ns, p99: ... ns
+mismatches: 0
+**/
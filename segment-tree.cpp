@@ -0,0 +1,75 @@
+/// Example driver for SegmentTree (see include/ads/segment-tree.h): reads the vector and the updates / queries from segment-tree.in
+/// and writes the minimum and the maximum of every queried subarray to segment-tree.out.
+
+#include <bits/stdc++.h>
+
+#include "include/ads/segment-tree.h"
+
+using ads :: SegmentTree;
+using ads :: minMonoid;
+using ads :: maxMonoid;
+
+std :: ifstream fin("segment-tree.in");
+std :: ofstream fout("segment-tree.out");
+
+int main() {
+    int n, Q;
+    std :: vector < long long > a;
+
+    fin >> n;
+
+    for (int i = 0, x; i < n; ++ i) {
+        fin >> x;
+
+        a.push_back(x);
+    }
+
+    SegmentTree < long long, minMonoid < long long > > Min(a); /// Both trees transform the 0-indexed vector into a 1-indexed vector.
+    SegmentTree < long long, maxMonoid < long long > > Max(a);
+
+    fin >> Q;
+
+    while (Q --) {
+        char c; /// Can take the following symbols: "+", "?".
+        int x, y, C;
+
+        /// + x y C -> adds C to all elements on [x, y]
+        /// ? x y -> queries the minimum and the maximum on [x, y]
+
+        fin >> c;
+
+        if (c == '+') {
+            fin >> x >> y >> C;
+
+            Min.Update(x, y, C);
+            Max.Update(x, y, C);
+        }
+        else {
+            fin >> x >> y;
+
+            fout << Min.Query(x, y) << " " << Max.Query(x, y) << "\n";
+        }
+    }
+
+    return 0;
+}
+
+/**
+Example:
+
+Input:
+5
+1 2 3 4 5
+6
++ 1 3 3
++ 2 5 -6
+? 1 5
++ 1 1 2
+? 2 4
+? 1 1
+
+Output:
+-2 4
+-2 0
+6 6
+**/
@@ -0,0 +1,30 @@
+/// A minimal helper for the tests: check(condition, what) reports a failed check, and failures() is the exit code of the test
+/// (0 if every check passed), so ctest marks the test as failed.
+
+#ifndef ADS_TESTS_CHECK_H
+#define ADS_TESTS_CHECK_H
+
+#include <string>
+#include <iostream>
+
+inline int failed = 0;
+
+inline void check(bool condition, const std :: string &what) {
+    if (!condition) {
+        if (failed < 10) /// The first failures are enough to find the bug.
+            std :: cerr << "FAILED: " << what << "\n";
+
+        ++ failed;
+    }
+
+    return;
+}
+
+inline int failures() {
+    if (failed > 0)
+        std :: cerr << failed << " checks failed\n";
+
+    return (failed > 0);
+}
+
+#endif
@@ -0,0 +1,72 @@
+/// Checks components (see include/ads/components.h) against dsu :: add, on random graphs and several numbers of threads,
+/// and checks that a dsu loaded with the labels (dsu :: load) keeps answering like the dsu which added every edge.
+
+#include <bits/stdc++.h>
+
+#include "../include/ads/components.h"
+#include "../include/ads/dsu.h"
+#include "check.h"
+
+void randomGraph(int n, int m, int seed) {
+    std :: mt19937 gen(seed);
+    std :: vector < std :: pair < int, int > > edges(m);
+
+    for (int i = 0; i < m; ++ i)
+        edges[i] = {int(gen() % n), int(gen() % n)};
+
+    std :: vector < long long > offsets;
+    std :: vector < int > adj;
+
+    ads :: toCSR(n, edges, offsets, adj);
+
+    ads :: dsu T(n);
+
+    for (int i = 0; i < m; ++ i)
+        T.add(edges[i].first, edges[i].second);
+
+    std :: vector < int > smallest(n, n); /// The smallest vertex of every component, by the root of T.
+
+    for (int x = 0; x < n; ++ x)
+        smallest[T.findRoot(x)] = std :: min(smallest[T.findRoot(x)], x);
+
+    std :: string what = "components n = " + std :: to_string(n) + ", m = " + std :: to_string(m) + ", seed = " + std :: to_string(seed);
+
+    std :: vector < int > label;
+
+    for (int threads = 1; threads <= 4; threads *= 2) {
+        label = ads :: components(n, offsets, adj, threads);
+
+        bool ok = (label.size() == n);
+
+        for (int x = 0; x < n && ok; ++ x)
+            ok = (label[x] == smallest[T.findRoot(x)]);
+
+        check(ok, what + ", threads = " + std :: to_string(threads));
+    }
+
+    ads :: dsu L(0);
+
+    L.load(label);
+
+    for (int i = 0; i < 200; ++ i) { /// The loaded dsu continues with new edges and queries.
+        int u = gen() % n, v = gen() % n;
+
+        if (gen() % 2 == 0)
+            check(L.add(u, v) == T.add(u, v), what + ": add after load");
+        else
+            check(L.query(u, v) == T.query(u, v), what + ": query after load");
+    }
+
+    return;
+}
+
+int main() {
+    for (int seed = 1; seed <= 30; ++ seed) {
+        randomGraph(seed * 10, seed * 5, seed); /// Many small components.
+        randomGraph(seed * 10, seed * 20, seed); /// Mostly one big component.
+    }
+
+    randomGraph(100000, 150000, 31); /// Enough vertices for several blocks of parallelFor on every thread.
+
+    return failures();
+}
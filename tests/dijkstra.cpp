@@ -0,0 +1,167 @@
+/// Checks dijkstra (see include/ads/dijkstra.h) against Bellman-Ford, on random directed graphs given as adjacency lists,
+/// as csrGraph files (with the state in memory and spilled to files) and as callbackGraphs (see include/ads/graph.h).
+/// Also checks that csrGraph :: write doesn't leave files behind when it fails.
+
+#include <bits/stdc++.h>
+
+#include <sys/wait.h>
+#include <sys/resource.h>
+
+#include "../include/ads/dijkstra.h"
+#include "check.h"
+
+const long long INF = 1e9; /// The distance dijkstra gives to the vertices which aren't reachable.
+
+std :: vector < long long > bellmanFord(int n, const std :: vector < std :: array < long long, 3 > > &edges, int source) {
+    std :: vector < long long > dist(n, INF);
+
+    dist[source] = 0;
+
+    for (int k = 0; k < n; ++ k)
+        for (int i = 0; i < edges.size(); ++ i)
+            if (dist[edges[i][0]] != INF)
+                dist[edges[i][1]] = std :: min(dist[edges[i][1]], dist[edges[i][0]] + edges[i][2]);
+
+    return dist;
+}
+
+void randomGraph(int n, int m, int seed) {
+    std :: mt19937 gen(seed);
+    std :: vector < std :: array < long long, 3 > > edges(m);
+    std :: vector < std :: vector < std :: pair < long long, int > > > G(n + 1);
+
+    for (int i = 0; i < m; ++ i) {
+        edges[i] = {(long long)(gen() % n), (long long)(gen() % n), (long long)(gen() % 100)};
+        G[edges[i][0]].push_back({edges[i][2], (int)edges[i][1]});
+    }
+
+    int source = gen() % n;
+
+    std :: vector < long long > expected = bellmanFord(n, edges, source);
+    ads :: stats S;
+    std :: vector < long long > dist = ads :: dijkstra(G.data(), n, source), counted = ads :: dijkstra(G.data(), n, source, S);
+
+    std :: string what = "dijkstra n = " + std :: to_string(n) + ", m = " + std :: to_string(m) + ", seed = " + std :: to_string(seed);
+
+    check(std :: equal(expected.begin(), expected.end(), dist.begin()), what);
+    check(std :: equal(expected.begin(), expected.end(), counted.begin()), what + " (with stats)");
+
+    auto same = [&](ads :: spillArray < long long > &d) { /// The providers give numeric_limits :: max() to the vertices which aren't reachable.
+        bool ok = (d.size() == n);
+
+        for (int i = 0; i < n && ok; ++ i)
+            ok = (d[i] == (expected[i] == INF ? std :: numeric_limits < long long > :: max() : expected[i]));
+
+        return ok;
+    };
+
+    std :: stringstream in; /// The edges sorted by source.
+    std :: string name = "test-dijkstra-" + std :: to_string(seed) + ".csr";
+
+    in << n << " " << m << "\n";
+
+    for (int u = 0; u < n; ++ u)
+        for (int i = 0; i < G[u].size(); ++ i)
+            in << u << " " << G[u][i].second << " " << G[u][i].first << "\n";
+
+    std :: stringstream again(in.str());
+
+    ads :: csrGraph < long long > :: write(in, name.c_str());
+    ads :: csrGraph < long long > :: write(again, (name + ".again").c_str());
+
+    auto bytes = [](std :: string path) {
+        std :: ifstream file(path, std :: ios :: binary);
+
+        return std :: string(std :: istreambuf_iterator < char > (file), std :: istreambuf_iterator < char > ());
+    };
+
+    check(bytes(name) == bytes(name + ".again"), what + " (the same edges give the same csrGraph file)");
+    unlink((name + ".again").c_str());
+
+    {
+        ads :: csrGraph < long long > C(name.c_str());
+        ads :: spillArray < long long > inMemory = ads :: dijkstra(C, source, 1LL << 30), spilled = ads :: dijkstra(C, source, 0);
+
+        check(C.size() == n && C.edgeCount() == m, what + " (csrGraph size)");
+        check(!inMemory.spilled() && same(inMemory), what + " (csrGraph)");
+        check(spilled.spilled() && same(spilled), what + " (csrGraph, spilled)");
+    }
+
+    unlink(name.c_str());
+
+    auto callback = ads :: makeCallbackGraph < long long > (n, [&](int u, auto emit) {
+        for (int i = 0; i < G[u].size(); ++ i)
+            emit(G[u][i].second, G[u][i].first);
+    });
+
+    ads :: spillArray < long long > fromCallback = ads :: dijkstra(callback, source, 1LL << 30);
+
+    check(same(fromCallback), what + " (callbackGraph)");
+
+    return;
+}
+
+bool exists(const char *path) {
+    return (access(path, F_OK) == 0);
+}
+
+void failedWrites() {
+    std :: stringstream unsorted("3 2\n1 2 5\n0 1 7\n"), outside("3 1\n0 3 5\n"), empty(""), negative("-1 0\n"), garbled("3 x\n");
+
+    for (std :: stringstream *in : {&unsorted, &outside, &empty, &negative, &garbled}) {
+        bool thrown = false;
+
+        try {
+            ads :: csrGraph < long long > :: write(*in, "test-dijkstra-invalid.csr");
+        }
+        catch (const std :: runtime_error &) {
+            thrown = true;
+        }
+
+        check(thrown && !exists("test-dijkstra-invalid.csr"), "csrGraph :: write with invalid sizes or edges");
+    }
+
+    pid_t child = fork();
+
+    if (child == 0) { /// A full disk: the file can't grow beyond 4 KB.
+        rlimit limit = {4096, 4096};
+
+        signal(SIGXFSZ, SIG_IGN);
+        setrlimit(RLIMIT_FSIZE, &limit);
+
+        std :: stringstream in;
+
+        in << 1000 << " " << 10000 << "\n";
+
+        for (int i = 0; i < 10000; ++ i)
+            in << i / 10 << " " << i % 1000 << " 1\n";
+
+        try {
+            ads :: csrGraph < long long > :: write(in, "test-dijkstra-full.csr");
+        }
+        catch (const std :: runtime_error &) {
+            _exit(exists("test-dijkstra-full.csr") ? 2 : 0);
+        }
+
+        _exit(1);
+    }
+
+    int status;
+
+    waitpid(child, &status, 0);
+
+    check(WIFEXITED(status) && WEXITSTATUS(status) == 0, "csrGraph :: write on a full disk throws and removes the file");
+
+    unlink("test-dijkstra-full.csr");
+
+    return;
+}
+
+int main() {
+    for (int seed = 1; seed <= 50; ++ seed)
+        randomGraph(1 + seed % 30, seed * 3, seed);
+
+    failedWrites();
+
+    return failures();
+}
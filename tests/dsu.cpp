@@ -0,0 +1,93 @@
+/// Checks dsu (see include/ads/dsu.h) against a brute force which relabels a whole component on every union.
+
+#include <bits/stdc++.h>
+
+#include "../include/ads/dsu.h"
+#include "check.h"
+
+template < typename Stats >
+    void randomOperations(int n, int Q, int seed) {
+        std :: mt19937 gen(seed);
+        ads :: dsu < Stats > T(n);
+        std :: vector < int > label(n);
+
+        for (int i = 0; i < n; ++ i)
+            label[i] = i;
+
+        for (int i = 0; i < Q; ++ i) {
+            int u = gen() % n, v = gen() % n;
+            std :: string what = "dsu n = " + std :: to_string(n) + ", seed = " + std :: to_string(seed) + ", operation " + std :: to_string(i);
+
+            if (gen() % 2 == 0) {
+                bool joined = (label[u] != label[v]);
+
+                check(T.add(u, v) == joined, what + ": add");
+
+                if (joined) {
+                    int old = label[v];
+
+                    for (int x = 0; x < n; ++ x)
+                        if (label[x] == old)
+                            label[x] = label[u];
+                }
+            }
+            else
+                check(T.query(u, v) == (label[u] == label[v]), what + ": query");
+        }
+
+        return;
+    }
+
+void rollbackOperations(int n, int Q, int seed) {
+    /// rollbackDsu, with the unions undone in reverse order and checked against the saved labels.
+
+    std :: mt19937 gen(seed);
+    ads :: rollbackDsu T(n);
+    std :: vector < std :: vector < int > > history; /// The labels before every union which is still done.
+    std :: vector < int > label(n);
+
+    for (int i = 0; i < n; ++ i)
+        label[i] = i;
+
+    for (int i = 0; i < Q; ++ i) {
+        int u = gen() % n, v = gen() % n, op = gen() % 3;
+        std :: string what = "rollbackDsu n = " + std :: to_string(n) + ", seed = " + std :: to_string(seed) + ", operation " + std :: to_string(i);
+
+        if (op == 0) {
+            bool joined = (label[u] != label[v]);
+
+            check(T.add(u, v) == joined, what + ": add");
+
+            if (joined) {
+                history.push_back(label);
+
+                int old = label[v];
+
+                for (int x = 0; x < n; ++ x)
+                    if (label[x] == old)
+                        label[x] = label[u];
+            }
+        }
+        else if (op == 1 && !history.empty()) {
+            T.rollback();
+            label = history.back();
+            history.pop_back();
+        }
+        else
+            check(T.query(u, v) == (label[u] == label[v]), what + ": query");
+    }
+
+    return;
+}
+
+int main() {
+    for (int seed = 1; seed <= 20; ++ seed) {
+        int n = 1 + seed * 5;
+
+        randomOperations < ads :: noStats > (n, 2000, seed);
+        randomOperations < ads :: stats > (n, 200, seed);
+        rollbackOperations(n, 2000, seed);
+    }
+
+    return failures();
+}
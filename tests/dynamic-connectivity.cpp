@@ -0,0 +1,163 @@
+/// Checks solver and chunkedSolver (at every window size, see include/ads/dynamic-connectivity.h) against a brute force
+/// which keeps the set of edges and searches the graph on every query, and timeline < parityDsu > against a 2-coloring.
+
+#include <bits/stdc++.h>
+
+#include "../include/ads/dynamic-connectivity.h"
+#include "check.h"
+
+std :: vector < ads :: Query > randomLog(int n, int Q, int seed) {
+    /// Mostly adds and removes edges which exist, so the components keep changing.
+
+    std :: mt19937 gen(seed);
+    std :: vector < ads :: Query > v;
+    std :: vector < std :: pair < int, int > > added;
+
+    for (int i = 0; i < Q; ++ i) {
+        int op = gen() % 3, u = gen() % n + 1, w = gen() % n + 1;
+
+        if (op == 1 && !added.empty() && gen() % 4 != 0) {
+            std :: pair < int, int > e = added[gen() % added.size()];
+
+            u = e.first;
+            w = e.second;
+
+            if (gen() % 2 == 0)
+                std :: swap(u, w);
+        }
+
+        if (op == 0)
+            added.push_back({u, w});
+
+        v.push_back({op == 0 ? '+' : op == 1 ? '-' : '?', u, w});
+    }
+
+    return v;
+}
+
+std :: vector < int > bruteForce(const std :: vector < ads :: Query > &v) {
+    std :: set < std :: pair < int, int > > edges;
+    std :: vector < int > ans;
+
+    for (int i = 0; i < v.size(); ++ i) {
+        std :: pair < int, int > e = {std :: min(v[i].u, v[i].v), std :: max(v[i].u, v[i].v)};
+
+        if (v[i].c == '+')
+            edges.insert(e);
+        else if (v[i].c == '-')
+            edges.erase(e);
+        else {
+            std :: set < int > seen = {v[i].u};
+            std :: vector < int > st = {v[i].u};
+
+            while (!st.empty()) {
+                int x = st.back();
+
+                st.pop_back();
+
+                for (std :: set < std :: pair < int, int > > :: iterator it = edges.begin(); it != edges.end(); ++ it) {
+                    int y = (it -> first == x ? it -> second : it -> second == x ? it -> first : -1);
+
+                    if (y != -1 && seen.insert(y).second)
+                        st.push_back(y);
+                }
+            }
+
+            ans.push_back(seen.count(v[i].v));
+        }
+    }
+
+    return ans;
+}
+
+std :: vector < int > bruteParity(const std :: vector < ads :: Query > &v) {
+    /// 2-colors the component of u: -1 if v isn't in it or if it has an odd cycle, otherwise whether u and v have different colors.
+
+    std :: set < std :: pair < int, int > > edges;
+    std :: vector < int > ans;
+
+    for (int i = 0; i < v.size(); ++ i) {
+        std :: pair < int, int > e = {std :: min(v[i].u, v[i].v), std :: max(v[i].u, v[i].v)};
+
+        if (v[i].c == '+')
+            edges.insert(e);
+        else if (v[i].c == '-')
+            edges.erase(e);
+        else {
+            std :: map < int, int > color = {{v[i].u, 0}};
+            std :: vector < int > st = {v[i].u};
+            bool odd = false;
+
+            while (!st.empty()) {
+                int x = st.back();
+
+                st.pop_back();
+
+                for (std :: set < std :: pair < int, int > > :: iterator it = edges.begin(); it != edges.end(); ++ it) {
+                    int y = (it -> first == x ? it -> second : it -> second == x ? it -> first : -1);
+
+                    if (y == -1)
+                        continue;
+
+                    if (color.count(y) == 0) {
+                        color[y] = color[x] ^ 1;
+                        st.push_back(y);
+                    }
+                    else if (color[y] == color[x])
+                        odd = true;
+                }
+            }
+
+            ans.push_back(color.count(v[i].v) == 0 || odd ? -1 : color[v[i].u] ^ color[v[i].v]);
+        }
+    }
+
+    return ans;
+}
+
+std :: vector < int > chunked(const std :: vector < ads :: Query > &v, int window) {
+    std :: stringstream in, out;
+
+    in << v.size() << "\n";
+
+    for (int i = 0; i < v.size(); ++ i)
+        in << v[i].c << " " << v[i].u << " " << v[i].v << "\n";
+
+    ads :: chunkedSolver G(window);
+
+    G.solve(in, out);
+
+    std :: vector < int > ans;
+
+    for (int x; out >> x; )
+        ans.push_back(x);
+
+    return ans;
+}
+
+int main() {
+    for (int seed = 1; seed <= 30; ++ seed) {
+        int n = 2 + seed % 10, Q = 10 * seed;
+        std :: vector < ads :: Query > v = randomLog(n, Q, seed);
+        std :: vector < int > expected = bruteForce(v);
+
+        std :: string what = "n = " + std :: to_string(n) + ", Q = " + std :: to_string(Q) + ", seed = " + std :: to_string(seed);
+
+        ads :: solver G(v);
+
+        check(G.solve() == expected, "solver " + what);
+
+        ads :: solver < ads :: stats > S(v);
+
+        check(S.solve() == expected, "solver < stats > " + what);
+
+        for (int window = 1; window <= Q + 1; ++ window)
+            check(chunked(v, window) == expected, "chunkedSolver window = " + std :: to_string(window) + ", " + what);
+
+        ads :: timeline < ads :: parityDsu > P(v);
+
+        check(P.solve() == bruteParity(v), "timeline < parityDsu > " + what);
+    }
+
+    return failures();
+}
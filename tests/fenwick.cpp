@@ -0,0 +1,160 @@
+/// Checks Fenwick (see include/ads/fenwick.h) against a plain vector, in memory and in a file which is reopened,
+/// and checks that the files left by a crashed writer aren't opened.
+
+#include <bits/stdc++.h>
+
+#include <sys/wait.h>
+
+#include "../include/ads/fenwick.h"
+#include "check.h"
+
+void randomOperations(int n, int Q, int seed) {
+    std :: mt19937 gen(seed);
+    std :: vector < long long > a(n);
+
+    for (int i = 0; i < n; ++ i)
+        a[i] = (int)(gen() % 2001) - 1000;
+
+    ads :: Fenwick < long long > T(a);
+
+    for (int i = 0; i < Q; ++ i) {
+        int x = gen() % n + 1, y = gen() % n + 1; /// Query / Update also accept x > y.
+        std :: string what = "Fenwick n = " + std :: to_string(n) + ", seed = " + std :: to_string(seed) + ", operation " + std :: to_string(i);
+
+        if (gen() % 2 == 0) {
+            long long C = (int)(gen() % 2001) - 1000;
+
+            T.Update(x, y, C);
+
+            for (int j = std :: min(x, y); j <= std :: max(x, y); ++ j)
+                a[j - 1] += C;
+        }
+        else {
+            long long expected = 0;
+
+            for (int j = std :: min(x, y); j <= std :: max(x, y); ++ j)
+                expected += a[j - 1];
+
+            check(T.Query(x, y) == expected, what + ": Query(" + std :: to_string(x) + ", " + std :: to_string(y) + ")");
+        }
+    }
+
+    ads :: Fenwick < long long > copy(T), assigned(std :: vector < long long > (1, 0));
+
+    assigned = T;
+
+    check(copy.size() == n && assigned.size() == n, "Fenwick copies keep the size");
+    check(copy.Query(1, n) == T.Query(1, n) && assigned.Query(1, n) == T.Query(1, n), "Fenwick copies keep the sums");
+
+    copy.Update(1, n, 1);
+
+    check(copy.Query(1, n) == T.Query(1, n) + n, "Fenwick copies are independent");
+
+    return;
+}
+
+template < typename T >
+    bool opens(const char *path) {
+        try {
+            ads :: Fenwick < T > F(path);
+        }
+        catch (const std :: runtime_error &) {
+            return false;
+        }
+
+        return true;
+    }
+
+void fileOperations(int n, int seed) {
+    std :: mt19937 gen(seed);
+    std :: vector < long long > a(n);
+    std :: string name = "test-fenwick-" + std :: to_string(seed) + ".bin";
+    const char *path = name.c_str();
+
+    for (int i = 0; i < n; ++ i)
+        a[i] = (int)(gen() % 2001) - 1000;
+
+    ads :: Fenwick < long long > T(a);
+
+    auto updates = [&](ads :: Fenwick < long long > &F, int k) {
+        for (int i = 0; i < k; ++ i) {
+            int x = gen() % n + 1, y = gen() % n + 1;
+            long long C = (int)(gen() % 2001) - 1000;
+
+            F.Update(x, y, C);
+            T.Update(x, y, C);
+        }
+    };
+
+    auto same = [&](ads :: Fenwick < long long > &F, std :: string what) {
+        bool ok = (F.size() == n);
+
+        for (int x = 1; x <= n && ok; ++ x)
+            ok = (F.Query(x, n) == T.Query(x, n));
+
+        check(ok, "Fenwick file n = " + std :: to_string(n) + ", seed = " + std :: to_string(seed) + ": " + what);
+    };
+
+    {
+        ads :: Fenwick < long long > F(a, path);
+
+        updates(F, 100);
+        F.checkpoint();
+        updates(F, 100); /// Saved by the destructor.
+    }
+
+    {
+        ads :: Fenwick < long long > F(path);
+
+        same(F, "reopened");
+        updates(F, 100);
+    }
+
+    {
+        ads :: Fenwick < long long > F(path);
+
+        same(F, "reopened twice");
+    }
+
+    check(!opens < int > (path), "Fenwick file opened with another type");
+
+    if (fork() == 0) { /// A writer which dies after some updates, without a checkpoint.
+        ads :: Fenwick < long long > F(path);
+
+        F.Update(1, n, 1);
+        _exit(0);
+    }
+
+    wait(nullptr);
+
+    check(!opens < long long > (path), "Fenwick file opened after its writer died during the updates");
+
+    {
+        ads :: Fenwick < long long > F(a, path); /// Rebuilt, then left as a build which didn't finish.
+    }
+
+    int fd = open(path, O_RDWR), clean = 0;
+
+    check(pwrite(fd, &clean, sizeof(clean), offsetof(ads :: fenwickHeader, clean)) == sizeof(clean), "Fenwick file can be written");
+    close(fd);
+
+    check(!opens < long long > (path), "Fenwick file opened after its writer died during the build");
+
+    truncate(path, sizeof(ads :: fenwickHeader) + 8);
+
+    check(!opens < long long > (path), "Fenwick file opened after it was truncated");
+
+    unlink(path);
+
+    return;
+}
+
+int main() {
+    for (int seed = 1; seed <= 20; ++ seed)
+        randomOperations(seed * 7, 2000, seed);
+
+    for (int seed = 1; seed <= 5; ++ seed)
+        fileOperations(seed * 100, seed);
+
+    return failures();
+}
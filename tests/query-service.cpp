@@ -0,0 +1,162 @@
+/// Checks latencyHistogram against the sorted values, and queryService (see include/ads/query-service.h) against a local dsu and
+/// Fenwick tree which answer the same requests one by one, over a socket pair served by the event loop.
+
+#include <bits/stdc++.h>
+
+#include "../include/ads/query-service.h"
+#include "check.h"
+
+void histogram(int k, int seed) {
+    std :: mt19937_64 gen(seed);
+    std :: vector < long long > v(k);
+    ads :: latencyHistogram H, first, second;
+
+    for (int i = 0; i < k; ++ i) {
+        v[i] = gen() >> (1 + gen() % 63); /// Non-negative, of every magnitude.
+        H.record(v[i]);
+        (i % 2 == 0 ? first : second).record(v[i]);
+    }
+
+    first.merge(second);
+    std :: sort(v.begin(), v.end());
+
+    std :: string what = "latencyHistogram k = " + std :: to_string(k) + ", seed = " + std :: to_string(seed);
+
+    check(H.count() == k && first.count() == k, what + ": count");
+
+    for (double p : {1.0, 10.0, 50.0, 90.0, 99.0, 99.9, 100.0}) {
+        long long exact = v[std :: max(1LL, (long long)(p / 100 * k + 0.5)) - 1], found = H.percentile(p);
+
+        check(found <= exact && exact - found <= exact / 16, what + ": p" + std :: to_string(p));
+        check(first.percentile(p) == found, what + ": p" + std :: to_string(p) + " after merge");
+    }
+
+    return;
+}
+
+std :: vector < ads :: request > randomRequests(int n, int k, int seed) {
+    /// Mostly valid dsu / Fenwick requests, with some invalid ones and some percentiles.
+
+    std :: mt19937 gen(seed);
+    std :: vector < ads :: request > req(k);
+    const int ops[] = {'?', '+', 's', 'u', 'p', 'x'};
+
+    for (int i = 0; i < k; ++ i) {
+        int op = ops[gen() % 100 < 96 ? gen() % 4 : 4 + gen() % 2];
+
+        req[i] = {(unsigned)i, op, (int)(gen() % (n + 1)), (int)(gen() % (n + 1)), (long long)(gen() % 2001) - 1000};
+
+        if (gen() % 50 == 0)
+            (gen() % 2 == 0 ? req[i].x : req[i].y) = (gen() % 2 == 0 ? -1 : n + 1);
+    }
+
+    return req;
+}
+
+std :: vector < ads :: response > expectedResponses(int n, const std :: vector < ads :: request > &req) {
+    /// The answers of the requests in their order, except the values of the percentiles (they depend on the time).
+
+    ads :: dsu <> D(n + 1);
+    ads :: Fenwick < long long > F(std :: vector < long long > (n, 0));
+    std :: vector < ads :: response > res(req.size());
+
+    for (int i = 0; i < req.size(); ++ i) {
+        const ads :: request &r = req[i];
+        bool fenwick = (r.op == 's' || r.op == 'u');
+
+        res[i] = {r.id, 1, 0};
+
+        if (r.op == 'p')
+            continue;
+
+        if (r.x < 0 || r.y < 0 || r.x > n || r.y > n || (fenwick && (r.x == 0 || r.y == 0)) || (r.op != '?' && r.op != '+' && !fenwick))
+            res[i].ok = 0;
+        else if (r.op == '?')
+            res[i].value = D.query(r.x, r.y);
+        else if (r.op == '+')
+            res[i].value = D.add(r.x, r.y);
+        else if (r.op == 's')
+            res[i].value = F.Query(r.x, r.y);
+        else
+            F.Update(r.x, r.y, r.val);
+    }
+
+    return res;
+}
+
+void service(int n, int k, int maxBatch, int seed) {
+    /// The requests are sent in two parts, the first one ending in the middle of a request.
+
+    std :: vector < ads :: request > req = randomRequests(n, k, seed);
+    std :: vector < ads :: response > expected = expectedResponses(n, req), res(k);
+
+    ads :: dsu <> D(n + 1);
+    ads :: Fenwick < long long > F(std :: vector < long long > (n, 0));
+    ads :: queryService S(D, F, n, maxBatch);
+    ads :: eventLoop loop;
+
+    int fd[2];
+
+    socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fd);
+    ads :: session(loop, S, fd[0]);
+
+    size_t received = 0; /// The number of bytes of res read from fd[1].
+    volatile std :: sig_atomic_t stop = 0;
+
+    auto exchange = [&](const char *p, size_t len, int upTo) {
+        /// Sends p[0 .. len - 1], then serves the connection until the responses of the first upTo requests are back.
+
+        check(write(fd[1], p, len) == (ssize_t)len, "queryService: the socket buffer holds the requests");
+
+        stop = 0;
+        loop.run(stop, [&]() {
+            bool busy = S.flush();
+            ssize_t r;
+
+            while ((r = read(fd[1], (char *)res.data() + received, k * sizeof(ads :: response) - received)) > 0)
+                received += r;
+
+            stop = (received >= upTo * sizeof(ads :: response));
+
+            return busy;
+        });
+    };
+
+    size_t cut = (k / 2) * sizeof(ads :: request) + 5;
+
+    exchange((const char *)req.data(), cut, k / 2);
+    exchange((const char *)req.data() + cut, k * sizeof(ads :: request) - cut, k);
+
+    std :: string what = "queryService n = " + std :: to_string(n) + ", maxBatch = " + std :: to_string(maxBatch) + ", seed = " + std :: to_string(seed);
+
+    check(received == k * sizeof(ads :: response), what + ": one response per request");
+
+    for (int i = 0; i < k; ++ i)
+        if (res[i].id != expected[i].id || res[i].ok != expected[i].ok || (req[i].op != 'p' && res[i].value != expected[i].value)) {
+            check(false, what + ": request " + std :: to_string(i));
+            break;
+        }
+
+    check(S.latency.count() == k, what + ": every request has a latency");
+
+    close(fd[1]); /// The session reads the end of the connection, and frees itself.
+
+    stop = 0;
+    loop.run(stop, [&]() {
+        stop = 1;
+
+        return false;
+    });
+
+    return;
+}
+
+int main() {
+    for (int seed = 1; seed <= 10; ++ seed)
+        histogram(seed * 1000, seed);
+
+    for (int seed = 1; seed <= 10; ++ seed)
+        service(1 + seed * 10, 3000, seed % 3 == 0 ? 1 : seed % 3 == 1 ? 7 : 4096, seed);
+
+    return failures();
+}
@@ -0,0 +1,53 @@
+/// Checks SegmentTree (see include/ads/segment-tree.h) with the sum, minimum and maximum monoids against a plain vector.
+
+#include <bits/stdc++.h>
+
+#include "../include/ads/segment-tree.h"
+#include "check.h"
+
+template < typename Monoid >
+    void randomOperations(std :: string name, int n, int Q, int seed) {
+        std :: mt19937 gen(seed);
+        std :: vector < long long > a(n);
+
+        for (int i = 0; i < n; ++ i)
+            a[i] = (int)(gen() % 2001) - 1000;
+
+        ads :: SegmentTree < long long, Monoid > T(a);
+
+        for (int i = 0; i < Q; ++ i) {
+            int x = gen() % n + 1, y = gen() % n + 1; /// Query / Update also accept x > y.
+            std :: string what = name + " n = " + std :: to_string(n) + ", seed = " + std :: to_string(seed) + ", operation " + std :: to_string(i);
+
+            if (gen() % 2 == 0) {
+                long long C = (int)(gen() % 2001) - 1000;
+
+                T.Update(x, y, C);
+
+                for (int j = std :: min(x, y); j <= std :: max(x, y); ++ j)
+                    a[j - 1] += C;
+            }
+            else {
+                long long expected = Monoid :: identity();
+
+                for (int j = std :: min(x, y); j <= std :: max(x, y); ++ j)
+                    expected = Monoid :: combine(expected, a[j - 1]);
+
+                check(T.Query(x, y) == expected, what + ": Query(" + std :: to_string(x) + ", " + std :: to_string(y) + ")");
+            }
+        }
+
+        return;
+    }
+
+int main() {
+    for (int seed = 1; seed <= 40; ++ seed) { /// Sizes which are and aren't powers of 2.
+        int n = seed * 3 - 2;
+
+        randomOperations < ads :: sumMonoid < long long > > ("sum", n, 2000, seed);
+        randomOperations < ads :: minMonoid < long long > > ("min", n, 2000, seed);
+        randomOperations < ads :: maxMonoid < long long > > ("max", n, 2000, seed);
+    }
+
+    return failures();
+}